@@ -96,9 +96,23 @@
 #include "sim_timer.h"
 #include <math.h>
 
+/* P2 can be run on a host thread of its own. Register macros index on
+   cpu_index, so it is kept per thread. */
+#if !defined(_WIN32) || defined(USE_READER_THREAD)
+#include <pthread.h>
+#define CPU_THREAD      1
+#endif
+#if defined(_MSC_VER)
+#define THREAD_LOCAL    __declspec(thread)
+#else
+#define THREAD_LOCAL    __thread
+#endif
+
 #define UNIT_V_MSIZE    (UNIT_V_UF + 0)
 #define UNIT_MSIZE      (7 << UNIT_V_MSIZE)
 #define MEMAMOUNT(x)    (x << UNIT_V_MSIZE)
+#define UNIT_V_PARALLEL (UNIT_V_UF + 3)
+#define UNIT_PARALLEL   (1 << UNIT_V_PARALLEL)
 
 #define TMR_RTC         0
 
@@ -189,7 +203,8 @@ uint8 rank[64] = {
 };
 
 
-int                 cpu_index;                  /* Current running cpu */
+THREAD_LOCAL int    cpu_index;                  /* Current running cpu */
+THREAD_LOCAL uint8  cpu_on_thread;              /* Set on the P2 thread */
 t_uint64            M[MAXMEMSIZE] = { 0 };      /* memory */
 t_uint64            a_reg[2];                   /* A register */
 t_uint64            b_reg[2];                   /* B register */
@@ -225,6 +240,20 @@ uint8               HALT;                       /* Set when halt requested */
 uint8               P1_run;                     /* Run flag for P1 */
 uint8               P2_run;                     /* Run flag for P2 */
 uint16              idle_addr = 0;              /* Address of idle loop */
+uint8               cpu_parallel;               /* P2 runs on its own thread */
+
+#if CPU_THREAD
+/* P2 thread. It sleeps on p2_wake until P2 is initiated and the simulator
+   is running, executes until P2 halts or the simulator stops, then clears
+   p2_busy and signals p2_idle. */
+static pthread_t        p2_thread;
+static pthread_mutex_t  p2_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   p2_wake = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t   p2_idle = PTHREAD_COND_INITIALIZER;
+static int              p2_started;             /* Thread created */
+static int              p2_busy;                /* Thread executing P2 */
+#endif
+static volatile int     p2_pause = 1;           /* sim_instr not running */
 
 
 struct InstHistory
@@ -273,6 +302,8 @@ t_stat              cpu_show_hist(FILE * st, UNIT * uptr, int32 val,
 t_stat              cpu_set_hist(UNIT * uptr, int32 val, CONST char *cptr,
                                  void *desc);
 t_stat              cpu_help(FILE *, DEVICE *, UNIT *, int32, const char *);
+t_stat              cpu_set_parallel(UNIT * uptr, int32 val, CONST char *cptr,
+                                 void *desc);
 /* Interval timer */
 t_stat              rtc_srv(UNIT * uptr);
 
@@ -340,6 +371,10 @@ MTAB                cpu_mod[] = {
     {MTAB_XTD|MTAB_VDV, 0, NULL, "NOIDLE", &sim_clr_idle, NULL },
     {MTAB_XTD | MTAB_VDV | MTAB_NMO | MTAB_SHP, 0, "HISTORY", "HISTORY",
      &cpu_set_hist, &cpu_show_hist},
+    {UNIT_PARALLEL, 0, "INTERLEAVED", "INTERLEAVED", &cpu_set_parallel, NULL,
+     NULL, "Interleave P1 and P2 on one thread"},
+    {UNIT_PARALLEL, UNIT_PARALLEL, "PARALLEL", "PARALLEL", &cpu_set_parallel,
+     NULL, NULL, "Run P2 on its own host thread"},
     {0}
 };
 
@@ -432,7 +467,8 @@ DEVICE              cpu_dev = {
 int memory_cycle(uint8 E) {
         uint16 addr = 0;
 
-        sim_interval--;
+        if (!cpu_on_thread)
+            sim_interval--;
         if (E & 2)
            addr = S;
         if (E & 4)
@@ -925,6 +961,35 @@ void initiate() {
     TROF = 0;
 }
 
+/* P2 has stopped. On its own thread this is published under the lock, so
+   P1 sees everything P2 stored before it. */
+static void p2_halted(void) {
+#if CPU_THREAD
+    if (cpu_on_thread)
+        pthread_mutex_lock(&p2_lock);
+#endif
+    P2_run = 0;
+    hltf[1] = 0;
+#if CPU_THREAD
+    if (cpu_on_thread)
+        pthread_mutex_unlock(&p2_lock);
+#endif
+}
+
+/* Check from P1 whether P2 is still running */
+static int p2_active(void) {
+    int         r = P2_run;
+
+#if CPU_THREAD
+    if (cpu_parallel) {
+        pthread_mutex_lock(&p2_lock);
+        r = P2_run;
+        pthread_mutex_unlock(&p2_lock);
+    }
+#endif
+    return r;
+}
+
 /* Save processor state in case of error or halt */
 void storeInterrupt(int forced, int test) {
     int         f;
@@ -998,8 +1063,7 @@ void storeInterrupt(int forced, int test) {
         GH = 0;
     } else if (forced) {
         if (cpu_index) {
-           P2_run = 0;          /* Clear halt flag */
-           hltf[1] = 0;
+           p2_halted();         /* Clear halt flag */
            cpu_index = 0;
         } else {
            T = WMOP_ITI;
@@ -1973,8 +2037,106 @@ void relativeAddr(int store) {
     Ma = (base + addr) & CORE;
 }
 
+static t_stat cpu_loop(void);
+
+#if CPU_THREAD
+/* Body of the P2 thread */
+static void *
+p2_main(void *arg)
+{
+    cpu_on_thread = 1;
+    pthread_mutex_lock(&p2_lock);
+    for (;;) {
+        while (p2_pause || P2_run == 0)
+            pthread_cond_wait(&p2_wake, &p2_lock);
+        p2_busy = 1;
+        pthread_mutex_unlock(&p2_lock);
+        cpu_index = 1;
+        cpu_loop();
+        pthread_mutex_lock(&p2_lock);
+        p2_busy = 0;
+        pthread_cond_broadcast(&p2_idle);
+    }
+    return NULL;
+}
+
+/* Let the P2 thread run while sim_instr does */
+static void
+p2_resume(void)
+{
+    pthread_mutex_lock(&p2_lock);
+    if (!p2_started) {
+        pthread_attr_t attr;
+
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        p2_started = (pthread_create(&p2_thread, &attr, p2_main, NULL) == 0);
+        pthread_attr_destroy(&attr);
+    }
+    p2_pause = 0;
+    pthread_cond_broadcast(&p2_wake);
+    pthread_mutex_unlock(&p2_lock);
+}
+
+/* Stop the P2 thread at an instruction boundary */
+static void
+p2_suspend(void)
+{
+    pthread_mutex_lock(&p2_lock);
+    p2_pause = 1;
+    while (p2_busy)
+        pthread_cond_wait(&p2_idle, &p2_lock);
+    pthread_mutex_unlock(&p2_lock);
+}
+
+/* Initiate P2 from P1 and hand it to its thread */
+static void
+p2_initiate(void)
+{
+    pthread_mutex_lock(&p2_lock);
+    while (p2_busy)
+        pthread_cond_wait(&p2_idle, &p2_lock);
+    hltf[1] = 0;
+    P2_run = 1;
+    cpu_index = 1;
+    Ma = 010;
+    memory_cycle(4);
+    sim_debug(DEBUG_DETAIL, &cpu_dev, "INIT P2\n");
+    initiate();
+    cpu_index = 0;
+    pthread_cond_broadcast(&p2_wake);
+    pthread_mutex_unlock(&p2_lock);
+}
+#endif
+
 t_stat
 sim_instr(void)
+{
+    t_stat              reason;
+
+    hltf[0] = 0;
+    hltf[1] = 0;
+    P1_run = 1;
+    cpu_parallel = (cpu_unit[0].flags & UNIT_PARALLEL) != 0;
+#if CPU_THREAD
+    if (cpu_parallel) {
+        cpu_index = 0;
+        p2_resume();
+    }
+#endif
+    reason = cpu_loop();
+#if CPU_THREAD
+    if (p2_started)
+        p2_suspend();
+#endif
+    return reason;
+}
+
+/* Execute instructions. P1 interleaves with P2 unless P2 has its own
+   thread, which runs this loop too and leaves events, breakpoints and
+   history to P1. */
+static t_stat
+cpu_loop(void)
 {
     t_stat              reason;
     t_uint64            temp = 0LL;
@@ -1988,43 +2150,45 @@ sim_instr(void)
     int                 j;
 
     reason = SCPE_OK;
-    hltf[0] = 0;
-    hltf[1] = 0;
-    P1_run = 1;
 
     while (reason == 0) {       /* loop until halted */
-        if (P1_run == 0)
-            return SCPE_STOP;
-        /* System is booting, wait until finished loading */
-        while (loading) {
-            reason = sim_process_event();
-            if (reason != SCPE_OK)
-                 break; /* process */
-            sim_interval--;
-        }
-        /* Passed time quantum */
-        if (sim_interval <= 0) {        /* event queue? */
-            reason = sim_process_event();
-            if (reason != SCPE_OK)
-                 break; /* process */
-        }
-
-        if (sim_brk_summ) {
-            if(sim_brk_test((C << 3) | L, SWMASK('E'))) {
-                reason = SCPE_STOP;
+        if (cpu_on_thread) {
+            if (p2_pause || P2_run == 0)
                 break;
+        } else {
+            if (P1_run == 0)
+                return SCPE_STOP;
+            /* System is booting, wait until finished loading */
+            while (loading) {
+                reason = sim_process_event();
+                if (reason != SCPE_OK)
+                     break; /* process */
+                sim_interval--;
             }
-
-            if (sim_brk_test((c_reg[0] << 3) | l_reg[0],
-                         SWMASK('A'))) {
-                reason = SCPE_STOP;
-                break;
+            /* Passed time quantum */
+            if (sim_interval <= 0) {        /* event queue? */
+                reason = sim_process_event();
+                if (reason != SCPE_OK)
+                     break; /* process */
             }
 
-            if (sim_brk_test((c_reg[1] << 3) | l_reg[1],
-                         SWMASK('B'))) {
-                reason = SCPE_STOP;
-                break;
+            if (sim_brk_summ) {
+                if(sim_brk_test((C << 3) | L, SWMASK('E'))) {
+                    reason = SCPE_STOP;
+                    break;
+                }
+
+                if (sim_brk_test((c_reg[0] << 3) | l_reg[0],
+                             SWMASK('A'))) {
+                    reason = SCPE_STOP;
+                    break;
+                }
+
+                if (sim_brk_test((c_reg[1] << 3) | l_reg[1],
+                             SWMASK('B'))) {
+                    reason = SCPE_STOP;
+                    break;
+                }
             }
         }
 
@@ -2034,7 +2198,11 @@ sim_instr(void)
                 storeInterrupt(1,0);
         }
 
-        if (cpu_index == 0 && P2_run == 1) {
+        /* On its own thread P2 stops once it has halted */
+        if (cpu_on_thread) {
+            if (cpu_index == 0)
+                break;
+        } else if (cpu_index == 0 && P2_run == 1 && !cpu_parallel) {
             cpu_index = 1;
         } else {
             cpu_index = 0;
@@ -2047,7 +2215,7 @@ crf_loop:
         field = (T >> 6) & 077;
         TROF = 0;
 
-        if (hst_lnt) {  /* history enabled? */
+        if (hst_lnt && !cpu_on_thread) {  /* history enabled? */
             /* Ignore idle loop when recording history */
                 /* DCMCP XIII */
             /* if ((C & 077774) != 01140) { */
@@ -3048,7 +3216,7 @@ control:
                         } else if (q_reg[0] & STK_OVERFL) {
                             C = STK_OVR_LOC;
                             q_reg[0] &= ~STK_OVERFL;
-                        } else if (P2_run == 0 && q_reg[1] != 0) {
+                        } else if (p2_active() == 0 && q_reg[1] != 0) {
                             if (q_reg[1] & MEM_PARITY) {
                                 C = PARITY_ERR2;
                                 q_reg[1] &= ~MEM_PARITY;
@@ -3146,7 +3314,7 @@ control:
                         if (NCSF)
                            break;
                         /* If CPU 2 is not running, or disabled nop */
-                        if (P2_run == 0 || (cpu_unit[1].flags & UNIT_DIS)) {
+                        if (p2_active() == 0 || (cpu_unit[1].flags & UNIT_DIS)) {
                             break;
                         }
                         sim_debug(DEBUG_DETAIL, &cpu_dev, "HALT P2\n");
@@ -3169,10 +3337,16 @@ control:
                         Ma = 010;
                         save_tos();
                         /* If CPU is operating, or disabled, return busy */
-                        if (P2_run != 0 || (cpu_unit[1].flags & UNIT_DIS)) {
+                        if (p2_active() != 0 || (cpu_unit[1].flags & UNIT_DIS)) {
                             IAR |= IRQ_11;      /* Set CPU 2 Busy */
                             break;
                         }
+#if CPU_THREAD
+                        if (cpu_parallel) {
+                            p2_initiate();
+                            break;
+                        }
+#endif
                         /* Ok we are going to initiate B.
                            load the initiate word from 010. */
                         hltf[1] = 0;
@@ -3659,7 +3833,7 @@ control:
                         do {
                             Ma = CF(B);
                             memory_cycle(5);
-                            if (sim_interval <= 0) {        /* event queue? */
+                            if (!cpu_on_thread && sim_interval <= 0) {
                                 reason = sim_process_event();
                                 if (reason != SCPE_OK) {
                                      break; /* process */
@@ -3930,6 +4104,21 @@ cpu_set_size(UNIT * uptr, int32 val, CONST char *cptr, void *desc)
         M[i] = 0;
     return SCPE_OK;
 }
+
+/* Select whether P2 interleaves with P1 or runs on its own thread */
+t_stat
+cpu_set_parallel(UNIT * uptr, int32 val, CONST char *cptr, void *desc)
+{
+#if !CPU_THREAD
+    if (val)
+        return sim_messagef(SCPE_NOFNC, "No thread support in this build\n");
+#endif
+    cpu_unit[0].flags &= ~UNIT_PARALLEL;
+    cpu_unit[0].flags |= val;
+    cpu_unit[1].flags &= ~UNIT_PARALLEL;
+    cpu_unit[1].flags |= val;
+    return SCPE_OK;
+}
 
 /* Handle execute history */
 
@@ -4042,7 +4231,13 @@ t_stat              cpu_help(FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag, con
     fprintf(st, "default. Use:\n");
     fprintf(st, "       sim> SET CPU1 ENABLE                enable second CPU\n");
     fprintf(st, "The primary CPU can't be disabled. Memory is shared between the two\n");
-    fprintf(st, "CPU's. Memory can be configured in 4K increments up to 32K total.\n");
+    fprintf(st, "CPU's. Memory can be configured in 4K increments up to 32K total.\n\n");
+    fprintf(st, "By default P2 is interleaved with P1 an instruction at a time, which\n");
+    fprintf(st, "is repeatable and is what should be used for diagnostics. Use:\n");
+    fprintf(st, "       sim> SET CPU PARALLEL               run P2 on its own host thread\n");
+    fprintf(st, "       sim> SET CPU INTERLEAVED            interleave P2 with P1\n");
+    fprintf(st, "In parallel mode P1 still handles all events and I/O, breakpoints are\n");
+    fprintf(st, "only checked on P1 and the history only records P1.\n");
     fprint_reg_help (st, dptr);
     fprint_set_help(st, dptr);
     fprint_show_help(st, dptr);
@@ -319,6 +319,7 @@ t_stat esu_srv(UNIT * uptr)
     int                 u = uptr - esu_unit;
     int                 dsk = ((uptr->CMD & DK_CTRL) != 0);
     int                 wc;
+    int                 n = 1;          /* Characters moved this time */
     
  
     /* Process for each unit */
@@ -356,12 +357,13 @@ t_stat esu_srv(UNIT * uptr)
             uptr->ADDR++; /* Advance disk address */
             uptr->CMD -= DK_SECT;
         }
-        /* Transfer one Character */
-        if (chan_write_char(chan, &dsk_buffer[dsk][uptr->POS], 0)) {
+        /* Transfer rest of segment */
+        n = DK_SEC_SIZE - uptr->POS;
+        if (chan_write_blk(chan, &dsk_buffer[dsk][uptr->POS], n) != n) {
                 esu_set_end(uptr, 0);
                 return SCPE_OK;
         }
-        uptr->POS++;
+        uptr->POS += n;
     }
 
     if (uptr->CMD & DK_RDCK) {
@@ -389,8 +391,9 @@ t_stat esu_srv(UNIT * uptr)
                 return SCPE_OK;
             }
         }
-        /* Check if at end of segment */
-        uptr->POS++;
+        /* Skip to end of segment */
+        n = DK_SEC_SIZE - uptr->POS;
+        uptr->POS = DK_SEC_SIZE;
     }
 
     /* Process for each unit */
@@ -401,14 +404,18 @@ t_stat esu_srv(UNIT * uptr)
             return SCPE_OK;
         }
 
-        /* Transfer one Character */
-        if (chan_read_char(chan, &dsk_buffer[dsk][uptr->POS], 0)) {
+        /* Transfer rest of segment */
+        n = DK_SEC_SIZE - uptr->POS;
+        wc = chan_read_blk(chan, &dsk_buffer[dsk][uptr->POS], n);
+        uptr->POS += wc;
+        if (wc != n) {
             if (uptr->POS != 0) {
                 while (uptr->POS < DK_SEC_SIZE) 
                     dsk_buffer[dsk][uptr->POS++] = (uptr->CMD & DK_BIN) ? 0 :020;
             }
+            uptr->POS++;
+            n = wc + 1;
         } 
-        uptr->POS++;
 
         /* Check if at end of segment */
         if (uptr->POS >= DK_SEC_SIZE) {
@@ -441,7 +448,7 @@ t_stat esu_srv(UNIT * uptr)
            uptr->CMD -= DK_SECT;
         } 
     }
-    sim_activate(uptr, (uptr->flags & MODIB) ? 500 :300);
+    sim_activate(uptr, n * ((uptr->flags & MODIB) ? 500 :300));
     return SCPE_OK;
 }
                 
@@ -39,6 +39,8 @@
 #define DR_WR           000010  /* Executing a write command */
 #define DR_RDY          000040  /* Device Ready */
 
+#define DR_BLK          256     /* Characters moved per service call */
+
 #define AUXMEM          (1 << UNIT_V_UF)
 
 t_stat              drm_srv(UNIT *);
@@ -117,17 +119,22 @@ t_stat drm_srv(UNIT * uptr)
 {
     int                 chan = uptr->CMD & DR_CHAN;
     uint8               *ch = &(((uint8 *)uptr->filebuf)[uptr->ADDR]);
+    int                 n;
     
+    /* Characters to move this time, up to one past the end of drum */
+    n = ((int32)uptr->capac << 3) - uptr->ADDR + 1;
+    if (n > DR_BLK)
+        n = DR_BLK;
  
     /* Process for each unit */
     if (uptr->CMD & DR_RD) {
-        /* Transfer one Character */
-        if (chan_write_drum(chan, ch, 0)) {
+        /* Transfer a block of characters */
+        if (chan_write_drum_blk(chan, ch, n) != n) {
                 uptr->CMD = DR_RDY;
                 chan_set_end(chan);
                 return SCPE_OK;
         }
-        uptr->ADDR++;
+        uptr->ADDR += n;
         if (uptr->ADDR > ((int32)uptr->capac << 3)) {
                 sim_debug(DEBUG_CMD, &drm_dev, "Drum overrun\n");
                 uptr->CMD = DR_RDY;
@@ -135,18 +142,18 @@ t_stat drm_srv(UNIT * uptr)
                 chan_set_end(chan);
                 return SCPE_OK;
         }
-        sim_activate(uptr, 40);
+        sim_activate(uptr, 40 * n);
     }
 
     /* Process for each unit */
     if (uptr->CMD & DR_WR) {
-        /* Transfer one Character */
-        if (chan_read_drum(chan, ch, 0)) {
+        /* Transfer a block of characters */
+        if (chan_read_drum_blk(chan, ch, n) != n) {
                 uptr->CMD = DR_RDY;
                 chan_set_end(chan);
                 return SCPE_OK;
         }
-        uptr->ADDR++;
+        uptr->ADDR += n;
         if (uptr->ADDR > ((int32)uptr->capac << 3)) {
                 sim_debug(DEBUG_CMD, &drm_dev, "Drum overrun\n");
                 uptr->CMD = DR_RDY;
@@ -154,7 +161,7 @@ t_stat drm_srv(UNIT * uptr)
                 chan_set_end(chan);
                 return SCPE_OK;
         }
-        sim_activate(uptr, 40);
+        sim_activate(uptr, 40 * n);
     }
 
     return SCPE_OK;
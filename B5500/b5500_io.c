@@ -440,6 +440,96 @@ chan_set_wc(int chan, uint16 wc) {
         11 1110         01 1110
         11 1111         01 1111 */
 
+/* Translate a BCL character from a device to BCD for memory */
+static uint8
+bcl_to_bcd(uint8 c) {
+        uint8   cx = c & 060;
+
+        c &= 017;
+        switch(c) {
+        case 0:
+                /* 11-0 -> 01 C */
+                /* 10-0 -> 10 C */
+                /* 01-0 -> 11 0 */
+                /* 00-0 -> 00 C */
+                if (cx != 020)
+                    c = 0xc;
+                break;
+        case 1:
+        case 2:
+        case 3:
+        case 4:
+        case 5:
+        case 6:
+        case 7:
+        case 8:
+        case 9:
+        case 0xd:
+        case 0xe:
+        case 0xf:
+                break;
+        case 0xa:
+                /* 11-A -> 01 0 */
+                /* 10-A -> 10 0 */
+                /* 01-A -> 11 C */
+                /* 00-A -> 00 0 */
+                if (cx == 020)
+                    c = 0xc;
+                else
+                    c = 0;
+                break;
+        case 0xb:
+                c = 0xa;
+                break;
+        case 0xc:
+                c = 0xb;
+                break;
+        }
+        c |= cx ^ ((cx & 020)<<1);
+        return c;
+}
+
+/* Translate a BCD character from memory to BCL for a device */
+static uint8
+bcd_to_bcl(uint8 c) {
+        uint8   cx = c & 060;
+
+        c &= 017;
+        switch(c) {
+        case 0:
+                if (cx != 060)
+                    c = 0xa;
+                break;
+        case 1:
+        case 2:
+        case 3:
+        case 4:
+        case 5:
+        case 6:
+        case 7:
+        case 8:
+        case 9:
+        case 0xd:
+        case 0xe:
+        case 0xf:
+                break;
+        case 0xa:
+                c = 0xb;
+                break;
+        case 0xb:
+                c = 0xc;
+                break;
+        case 0xc:
+                if (cx == 060)
+                   c = 0xa;
+                else
+                   c = 0;
+                break;
+        }
+        c |= cx ^ ((cx & 020)<<1);
+        return c;
+}
+
 /* returns 1 when channel can take no more characters. 
    A return of 1 indicates that the character was not
    processed.
@@ -468,52 +558,8 @@ int chan_write_char(int chan, uint8 *ch, int flags) {
         }
 
         c = *ch & 077;
-        if ((D[chan] & DEV_BIN) == 0) {
-                /* Translate BCL to BCD */
-                uint8   cx = c & 060;
-        
-                c &= 017;
-                switch(c) {
-                case 0:
-                        /* 11-0 -> 01 C */
-                        /* 10-0 -> 10 C */
-                        /* 01-0 -> 11 0 */
-                        /* 00-0 -> 00 C */
-                        if (cx != 020)
-                            c = 0xc;
-                        break;
-                case 1:
-                case 2:
-                case 3:
-                case 4:
-                case 5:
-                case 6:
-                case 7:
-                case 8:
-                case 9:
-                case 0xd:
-                case 0xe:
-                case 0xf:
-                        break;
-                case 0xa:
-                        /* 11-A -> 01 0 */
-                        /* 10-A -> 10 0 */
-                        /* 01-A -> 11 C */
-                        /* 00-A -> 00 0 */
-                        if (cx == 020)
-                            c = 0xc;
-                        else
-                            c = 0;
-                        break;
-                case 0xb:
-                        c = 0xa;
-                        break;
-                case 0xc:
-                        c = 0xb;
-                        break;
-                }
-                c |= cx ^ ((cx & 020)<<1);
-        }
+        if ((D[chan] & DEV_BIN) == 0)
+                c = bcl_to_bcd(c);
 
         if (D[chan] & DEV_BACK) 
             W[chan] |= ((t_uint64)c) << ((CC[chan]) * 6);
@@ -599,43 +645,8 @@ int chan_read_char(int chan, uint8 *ch, int flags) {
         if (CC[chan] == 8) {
             CC[chan] = 0;
         }
-        if ((D[chan] & DEV_BIN) == 0) {
-                /* Translate BCD to BCL */
-                uint8   cx = c & 060;
-                c &= 017;
-                switch(c) {
-                case 0:
-                        if (cx != 060)
-                            c = 0xa;
-                        break;
-                case 1:
-                case 2:
-                case 3:
-                case 4:
-                case 5:
-                case 6:
-                case 7:
-                case 8:
-                case 9:
-                case 0xd:
-                case 0xe:
-                case 0xf:
-                        break;
-                case 0xa:
-                        c = 0xb;
-                        break;
-                case 0xb:
-                        c = 0xc;
-                        break;
-                case 0xc:
-                        if (cx == 060)
-                           c = 0xa;
-                        else
-                           c = 0;
-                        break;
-                }
-                c |= cx ^ ((cx & 020)<<1);
-        }
+        if ((D[chan] & DEV_BIN) == 0)
+                c = bcd_to_bcl(c);
         *ch = c;
         if ((status[chan] & USEGM) != 0 && (D[chan] & DEV_WCFLG) == 0 && gm) {
             status[chan] |= EOR;
@@ -647,6 +658,98 @@ int chan_read_char(int chan, uint8 *ch, int flags) {
         return 0;
 }
 
+/* Move up to len characters from a device buffer to memory. Whole
+   words are packed and stored in one step, anything else goes through
+   chan_write_char. Returns the number of characters taken, if less than
+   len the channel can take no more and buf[n] was not processed, just as
+   if chan_write_char had returned 1 for it.
+*/
+int chan_write_blk(int chan, uint8 *buf, int len) {
+        int     i = 0;
+        int     j;
+
+        while (i < len) {
+            if (CC[chan] == 0 && (len - i) >= 8 &&
+                (status[chan] & EOR) == 0 &&
+                (D[chan] & DEV_INHTRF) == 0 &&
+                ((D[chan] & DEV_WCFLG) == 0 || WC(D[chan]) != 0)) {
+                uint16      addr = (uint16)(D[chan] & CORE);
+                t_uint64    w = 0;
+
+                for (j = 0; j < 8; j++) {
+                    uint8   c = buf[i + j] & 077;
+
+                    if ((D[chan] & DEV_BIN) == 0)
+                        c = bcl_to_bcd(c);
+                    if (D[chan] & DEV_BACK) 
+                        w |= ((t_uint64)c) << (j * 6);
+                    else
+                        w |= ((t_uint64)c) << ((7 - j) * 6);
+                }
+                W[chan] = w;
+                CC[chan] = 8;
+                M[addr] = w;
+                sim_debug(DEBUG_DATA, &chan_dev, "write(%d, %05o, %016llo)\n", 
+                            chan, addr, w);   
+                if (chan_advance(chan)) 
+                    return i + 7;
+                W[chan] = 0;
+                i += 8;
+                continue;
+            }
+            if (chan_write_char(chan, &buf[i], 0))
+                return i;
+            i++;
+        }
+        return len;
+}
+
+/* Move up to len characters from memory to a device buffer, unpacking
+   a whole word at a time. Returns the number of characters delivered,
+   if less than len the channel has ended and buf[n] is not valid, just
+   as if chan_read_char had returned 1 for it.
+*/
+int chan_read_blk(int chan, uint8 *buf, int len) {
+        int     i = 0;
+        int     gm;
+        uint8   c;
+
+        while (i < len) {
+            if (CC[chan] == 0 && (len - i) >= 8 &&
+                (status[chan] & EOR) == 0 &&
+                (D[chan] & DEV_INHTRF) == 0) {
+                uint16      addr = (uint16)(D[chan] & CORE);
+
+                if (chan_advance(chan))
+                    return i;
+                sim_debug(DEBUG_DATA, &chan_dev, "read(%d, %05o, %016llo)\n", chan,
+                     addr, W[chan]);   
+                do {
+                    if (D[chan] & DEV_BACK) 
+                        c = 077 & (W[chan] >> ((CC[chan]) * 6));
+                    else
+                        c = 077 & (W[chan] >> ((7 - CC[chan]) * 6));
+                    gm = (c == 037);
+                    CC[chan] = (CC[chan] + 1) & 07;
+                    if ((D[chan] & DEV_BIN) == 0)
+                        c = bcd_to_bcl(c);
+                    buf[i] = c;
+                    if ((status[chan] & USEGM) != 0 &&
+                         (D[chan] & DEV_WCFLG) == 0 && gm) {
+                        status[chan] |= EOR;
+                        return i;
+                    }
+                    i++;
+                } while (CC[chan] != 0);
+                continue;
+            }
+            if (chan_read_char(chan, &buf[i], 0))
+                return i;
+            i++;
+        }
+        return len;
+}
+
 /* Same as chan_read_char, however we do not check word count 
    nor do we advance it. 
 */
@@ -747,6 +850,34 @@ int chan_write_drum(int chan, uint8 *ch, int flags) {
         return 0;
 }
 
+/* Block version of chan_write_drum, see chan_write_blk.  */
+int chan_write_drum_blk(int chan, uint8 *buf, int len) {
+        int     i = 0;
+        int     j;
+
+        while (i < len) {
+            if (CC[chan] == 0 && (len - i) >= 8 &&
+                (status[chan] & EOR) == 0 && WC(D[chan]) != 0) {
+                uint16      addr = (uint16)(D[chan] & CORE);
+                t_uint64    w = 0;
+
+                for (j = 0; j < 8; j++)
+                    w |= (t_uint64)(buf[i + j] & 077) << ((7 - j) * 6);
+                W[chan] = w;
+                CC[chan] = 8;
+                M[addr] = w;
+                if (chan_advance_drum(chan)) 
+                    return i + 7;
+                i += 8;
+                continue;
+            }
+            if (chan_write_drum(chan, &buf[i], 0))
+                return i;
+            i++;
+        }
+        return len;
+}
+
 /* Returns 1 on last character. If it returns 1, the
    character in ch is not valid. If flag is set to 1, then
    this is the last character the device will request.
@@ -775,3 +906,25 @@ int chan_read_drum(int chan, uint8 *ch, int flags) {
         return 0;
 }
 
+/* Block version of chan_read_drum, see chan_read_blk.  */
+int chan_read_drum_blk(int chan, uint8 *buf, int len) {
+        int     i = 0;
+
+        while (i < len) {
+            if (CC[chan] == 0 && (len - i) >= 8 &&
+                (status[chan] & EOR) == 0) {
+                if (chan_advance_drum(chan))
+                    return i;
+                do {
+                    buf[i++] = 077 & (W[chan] >> ((7 - CC[chan]) * 6));
+                    CC[chan]++;
+                } while (CC[chan] != 8);
+                CC[chan] = 0;
+                continue;
+            }
+            if (chan_read_drum(chan, &buf[i], 0))
+                return i;
+            i++;
+        }
+        return len;
+}
@@ -32,6 +32,7 @@ extern DEVICE      *sim_devices[];
 
 
 int     num_devs[NUM_CHAN];
+uint32  chan_pend;              /* Channels with possible work */
 
 
 t_stat
@@ -454,24 +455,28 @@ int chan_active(int chan)
 void
 chan_set_attn(int chan)
 {
+    chan_wake(chan);
     chan_flags[chan] |= CHS_ATTN;
 }
 
 void
 chan_set_eof(int chan)
 {
+    chan_wake(chan);
     chan_flags[chan] |= CHS_EOF;
 }
 
 void
 chan_set_error(int chan)
 {
+    chan_wake(chan);
     chan_flags[chan] |= CHS_ERR;
 }
 
 void
 chan_set_sel(int chan, int need)
 {
+    chan_wake(chan);
     chan_flags[chan] &=
         ~(DEV_WEOR | DEV_REOR | DEV_FULL | DEV_WRITE | DEV_DISCO);
     chan_flags[chan] |= DEV_SEL;
@@ -489,6 +494,7 @@ chan_clear_status(int chan)
 void
 chan_set(int chan, uint32 flag)
 {
+    chan_wake(chan);
     chan_flags[chan] |= flag;
 }
 
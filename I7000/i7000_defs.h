@@ -273,6 +273,7 @@ extern DEBTAB crd_debug[];
 /* Channel half of controls */
 /* Channel status */
 extern uint32   chan_flags[NUM_CHAN];         /* Channel flags */
+extern uint32   chan_pend;                    /* Channels chan_proc must scan */
 extern const char *chname[11];                /* Channel names */
 extern int      num_devs[NUM_CHAN];           /* Number devices per channel*/
 extern uint8    lpr_chan9[NUM_CHAN];
@@ -320,6 +321,11 @@ extern uint8    lpr_chan12[NUM_CHAN];
 #define DEV_DISCO       0x40000000      /* Channel is done with device */
 #define DEV_WEOR        0x80000000      /* Channel wants EOR written */
 
+/* Mark channel as needing a look from chan_proc. Anything that sets
+   flags or state that may give an idle channel work must do this,
+   chan_proc drops the channel again once it has nothing left to do. */
+#define chan_wake(chan) (chan_pend |= (1 << (chan)))
+
 /* Device status information stored in u5 */
 #define URCSTA_EOF      0001    /* Hit end of file */
 #define URCSTA_ERR      0002    /* Error reading record */
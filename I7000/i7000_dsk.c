@@ -101,12 +101,17 @@
 #define PROG_INVSEQ     0x48000         /* Invalid sequence */
 
 #define MAXTRACK        6020    /* Max size per track */
+#define DK_CACHE        16      /* Tracks cached per module */
 
 uint32              dsk_cmd(UNIT *, uint16, uint16);
 t_stat              dsk_srv(UNIT *);
 t_stat              dsk_boot(int32, DEVICE *);
 void                dsk_ini(UNIT *, t_bool);
 t_stat              dsk_reset(DEVICE *);
+t_stat              dsk_attach(UNIT *, CONST char *);
+t_stat              dsk_detach(UNIT *);
+t_stat              dsk_show_cache(FILE * st, UNIT * uptr, int32 v,
+                                 CONST void *desc);
 t_stat              dsk_set_module(UNIT * uptr, int32 val, CONST char *cptr,
                                    void *desc);
 t_stat              dsk_get_module(FILE * st, UNIT * uptr, int32 v,
@@ -119,6 +124,10 @@ t_stat              dsk_help (FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag,
                         const char *cptr);
 const char          *dsk_description (DEVICE *dptr);
 
+int                 disk_toffset(UNIT * uptr, int trk);
+struct dk_track     *disk_tc_find(UNIT * uptr, int trk, int load);
+void                disk_tc_flush(int m, struct dk_track *tp);
+void                disk_tc_purge(int m);
 int                 disk_rblock(UNIT * uptr, int track);
 int                 disk_wblock(UNIT * uptr);
 void                disk_posterr(UNIT * uptr, uint32 error);
@@ -145,6 +154,23 @@ uint16              dtrack[NUM_DEVS_DSK * 4];
 
 /* Arm position */
 uint16              arm_cyl[NUM_DEVS_DSK * 4];
+
+/* Track cache for each module. Track buffers are loaded from and written
+   to here, the file is only updated when a track is replaced or the
+   module is detached. */
+struct dk_track
+{
+    uint16              arm;    /* Arm unit + 1 owning track, 0 if free */
+    uint16              trk;    /* Track number */
+    uint8               dirty;  /* Needs to be written to file */
+    uint32              use;    /* Last reference, for replacement */
+    uint8               data[MAXTRACK];
+}
+dk_cache[NUM_DEVS_DSK][DK_CACHE];
+uint32              dk_use;                     /* Cache reference counter */
+uint32              dk_hits[NUM_DEVS_DSK];      /* Tracks found in cache */
+uint32              dk_misses[NUM_DEVS_DSK];    /* Tracks read from file */
+uint32              dk_wback[NUM_DEVS_DSK];     /* Tracks written to file */
 uint32              sense[NUM_CHAN * 2];
 uint32              sense_unit[NUM_CHAN * 2];
 uint8               cmd_buffer[NUM_CHAN];       /* Command buffer per channel */
@@ -276,6 +302,8 @@ MTAB                dsk_mod[] = {
 #endif
     {MTAB_XTD | MTAB_VUN | MTAB_VALR, 0, "TYPE", "TYPE",
      &dsk_set_type, &dsk_get_type, NULL, "Type of disk"},
+    {MTAB_XTD | MTAB_VUN, 0, "CACHE", NULL,
+     NULL, &dsk_show_cache, NULL, "Track cache statistics"},
     {MTAB_XTD | MTAB_VUN | MTAB_VALR, 0, "MODULE", "MODULE",
      &dsk_set_module, &dsk_get_module, NULL, "Module number"},
     {MTAB_XTD | MTAB_VUN | MTAB_VALR, 0, "CHAN", "CHAN",
@@ -290,7 +318,7 @@ MTAB                dsk_mod[] = {
 DEVICE              dsk_dev = {
     "DK", dsk_unit, NULL /* Registers */ , dsk_mod,
     NUM_DEVS_DSK, 8, 15, 1, 8, 8,
-    NULL, NULL, &dsk_reset, &dsk_boot, NULL, NULL,
+    NULL, NULL, &dsk_reset, &dsk_boot, &dsk_attach, &dsk_detach,
     &dsk_dib, DEV_DISABLE | DEV_DEBUG, 0, dev_debug,
     NULL, NULL, &dsk_help, NULL, NULL, &dsk_description
 };
@@ -835,7 +863,7 @@ clear_drive:
     /* Do command */
     switch (cmd_buffer[chan]) {
     case DSAI:          /* Set Access Inoperative */
-        detach_unit(base);
+        dsk_detach(base);
         disk_cmderr(up, 0);
         return 1;
 
@@ -994,6 +1022,86 @@ print_format(UNIT * uptr)
 }
 
 
+/* File offset of a track for given arm */
+int
+disk_toffset(UNIT * uptr, int trk)
+{
+    int                 u = uptr - dsk_unit;
+    struct disk_t      *dsk = &disk_type[uptr->u4];
+    int                 offset = 0;
+
+    offset = dsk->cyl * dsk->track * dsk->bpt;
+    offset *= u / (NUM_DEVS_DSK);
+    offset += dsk->fmtsz * dsk->mods * dsk->arms;
+    return offset + trk * dsk->bpt;
+}
+
+/* Write cached track back to file if it has been changed */
+void
+disk_tc_flush(int m, struct dk_track *tp)
+{
+    UNIT               *uptr;
+    FILE               *f = dsk_unit[m].fileref;
+
+    if (tp->arm == 0 || tp->dirty == 0)
+        return;
+    uptr = &dsk_unit[tp->arm - 1];
+    sim_debug(DEBUG_DETAIL, &dsk_dev, "unit=%d Flush track %d\n",
+              tp->arm - 1, tp->trk);
+    (void)sim_fseek(f, disk_toffset(uptr, tp->trk), SEEK_SET);
+    (void)sim_fwrite(tp->data, 1, disk_type[uptr->u4].bpt, f);
+    tp->dirty = 0;
+    dk_wback[m]++;
+}
+
+/* Find track in module cache, replacing the oldest entry if not there.
+   Data is read from the file when load is set. */
+struct dk_track *
+disk_tc_find(UNIT * uptr, int trk, int load)
+{
+    int                 u = uptr - dsk_unit;
+    int                 m = (uptr->u3 >> 8) & 0xf;
+    struct disk_t      *dsk = &disk_type[uptr->u4];
+    struct dk_track    *tp = &dk_cache[m][0];
+    struct dk_track    *vp = tp;
+    FILE               *f = dsk_unit[m].fileref;
+    int                 i;
+
+    for (i = 0; i < DK_CACHE; i++, tp++) {
+        if (tp->arm == (u + 1) && tp->trk == trk) {
+            tp->use = ++dk_use;
+            dk_hits[m]++;
+            return tp;
+        }
+        if (vp->arm != 0 && (tp->arm == 0 || tp->use < vp->use))
+            vp = tp;
+    }
+    disk_tc_flush(m, vp);
+    vp->arm = u + 1;
+    vp->trk = trk;
+    vp->use = ++dk_use;
+    vp->dirty = 0;
+    if (load) {
+        dk_misses[m]++;
+        (void)sim_fseek(f, disk_toffset(uptr, trk), SEEK_SET);
+        if (sim_fread(vp->data, 1, dsk->bpt, f) != dsk->bpt)
+            memset(vp->data, 0, dsk->bpt);
+    }
+    return vp;
+}
+
+/* Write back and drop all cached tracks of module */
+void
+disk_tc_purge(int m)
+{
+    int                 i;
+
+    for (i = 0; i < DK_CACHE; i++) {
+        disk_tc_flush(m, &dk_cache[m][i]);
+        dk_cache[m][i].arm = 0;
+    }
+}
+
 int
 disk_rblock(UNIT * uptr, int trk)
 {
@@ -1001,14 +1109,10 @@ disk_rblock(UNIT * uptr, int trk)
     struct disk_t      *dsk = &disk_type[uptr->u4];
     UNIT               *base = &dsk_unit[(uptr->u3 >> 8) & 0xf];
     FILE               *f = base->fileref;
-    int                 offset = 0;
     int                 fbase = 0;
 
-    offset = dsk->cyl * dsk->track * dsk->bpt;
     fbase = dsk->fmtsz;
-    offset *= u / (NUM_DEVS_DSK);
     fbase *= u / (NUM_DEVS_DSK);
-    offset += dsk->fmtsz * dsk->mods * dsk->arms;
 
     if (uptr->u5 & DSKSTA_DIRTY) {
         disk_wblock(uptr);
@@ -1024,9 +1128,7 @@ disk_rblock(UNIT * uptr, int trk)
     if (dtrack[u] != trk) {
         sim_debug(DEBUG_DETAIL, &dsk_dev, "unit=%d Read track %d\n", u,
                   trk);
-        (void)sim_fseek(f, offset + trk * dsk->bpt, SEEK_SET);
-        if (sim_fread(dbuffer[u], 1, dsk->bpt, f) != dsk->bpt)
-            memset(dbuffer[u], 0, dsk->bpt);
+        memcpy(dbuffer[u], disk_tc_find(uptr, trk, 1)->data, dsk->bpt);
         dtrack[u] = trk;
     }
     return 1;
@@ -1039,11 +1141,7 @@ disk_wblock(UNIT * uptr)
     struct disk_t      *dsk = &disk_type[uptr->u4];
     UNIT               *base = &dsk_unit[(uptr->u3 >> 8) & 0xf];
     FILE               *f = base->fileref;
-    int                 offset = 0;
-
-    offset = dsk->cyl * dsk->track * dsk->bpt;
-    offset *= u / (NUM_DEVS_DSK);
-    offset += dsk->fmtsz * dsk->mods * dsk->arms;
+    struct dk_track    *tp;
 
     /* Check if new format data */
     if ((uptr->u5 & DSKSTA_CMSK) == DWRF) {
@@ -1074,9 +1172,10 @@ disk_wblock(UNIT * uptr)
 
     sim_debug(DEBUG_DETAIL, &dsk_dev, "unit=%d Write track %d\n",
               u, dtrack[u]);
-    /* Write in actualy track data */
-    (void)sim_fseek(f, offset + dtrack[u] * dsk->bpt, SEEK_SET);
-    (void)sim_fwrite(dbuffer[u], 1, dsk->bpt, f);
+    /* Write in actualy track data, file updated when it leaves cache */
+    tp = disk_tc_find(uptr, dtrack[u], 0);
+    memcpy(tp->data, dbuffer[u], dsk->bpt);
+    tp->dirty = 1;
     uptr->u5 &= ~DSKSTA_DIRTY;
     return 1;
 }
@@ -1746,6 +1845,57 @@ dsk_reset(DEVICE * dptr)
     return SCPE_OK;
 }
 
+t_stat
+dsk_attach(UNIT * uptr, CONST char *file)
+{
+    int                 m = uptr - dsk_unit;
+
+    /* Cache should be empty, but make sure nothing stale is left */
+    if (m < NUM_DEVS_DSK && (uptr->flags & UNIT_ATT) == 0) {
+        int                 i;
+
+        for (i = 0; i < DK_CACHE; i++)
+            dk_cache[m][i].arm = 0;
+    }
+    return attach_unit(uptr, file);
+}
+
+t_stat
+dsk_detach(UNIT * uptr)
+{
+    int                 m = uptr - dsk_unit;
+    int                 i;
+
+    /* Write back cached tracks and forget buffers of all arms */
+    if (m < NUM_DEVS_DSK && (uptr->flags & UNIT_ATT)) {
+        disk_tc_purge(m);
+        for (i = m; i < NUM_DEVS_DSK * 4; i += NUM_DEVS_DSK) {
+            dtrack[i] = 077777;
+            fmt_cyl[i] = 077777;
+        }
+    }
+    return detach_unit(uptr);
+}
+
+t_stat
+dsk_show_cache(FILE * st, UNIT * uptr, int32 v, CONST void *desc)
+{
+    int                 m = uptr - dsk_unit;
+    int                 i, n = 0, d = 0;
+
+    if (m >= NUM_DEVS_DSK)
+        return SCPE_IERR;
+    for (i = 0; i < DK_CACHE; i++) {
+        if (dk_cache[m][i].arm != 0)
+            n++;
+        if (dk_cache[m][i].dirty)
+            d++;
+    }
+    fprintf(st, "cache %d/%d tracks %d dirty, hits=%u misses=%u writes=%u",
+            n, DK_CACHE, d, dk_hits[m], dk_misses[m], dk_wback[m]);
+    return SCPE_OK;
+}
+
 /* Disk option setting commands */
 
 t_stat
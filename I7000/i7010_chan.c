@@ -201,6 +201,7 @@ chan_reset(DEVICE * dptr)
     /* Clear channel assignment */
     for (i = 0; i < NUM_CHAN; i++) {
         chan_flags[i] = 0;
+        chan_wake(i);
         chunit[i] = 0;
         caddr[i] = 0;
         cmd[i] = 0;
@@ -229,6 +230,7 @@ chan_boot(int32 unit_num, DEVICE * dptr)
     cmd[chan] = CHAN_NOREC|CHAN_LOAD;
     chunit[chan] = unit_num;
     chan_flags[chan] |= STA_ACTIVE;
+    chan_wake(chan);
     return SCPE_OK;
 }
 
@@ -280,6 +282,16 @@ chan_issue_cmd(uint16 chan, uint16 dcmd, uint16 dev) {
     return SCPE_NODEV;
 }
 
+/* Check if channel has nothing for chan_proc to do */
+static int
+chan_idle(int chan)
+{
+    if (chan_flags[chan] & (CHS_EOF|CHS_ERR|CHS_ATTN|DEV_REOR|STA_ACTIVE|
+                            CTL_READ|CTL_WRITE))
+        return 0;
+    return (cmd[chan] & CHAN_DSK_SEEK) == 0;
+}
+
 /* Execute the next channel instruction. */
 void
 chan_proc()
@@ -287,12 +299,20 @@ chan_proc()
     int                 chan;
     int                 cmask;
 
+    /* Quick exit if all channels are idle */
+    if (chan_pend == 0)
+        return;
+
     /* Scan channels looking for work */
     for (chan = 0; chan < NUM_CHAN; chan++) {
+        if ((chan_pend & (1 << chan)) == 0)
+            continue;
 
-        /* Skip if channel is disabled */
-        if (chan_unit[chan].flags & UNIT_DIS)
+        /* Drop channel from scan if disabled or nothing to do */
+        if ((chan_unit[chan].flags & UNIT_DIS) || chan_idle(chan)) {
+            chan_pend &= ~(1 << chan);
             continue;
+        }
 
         cmask = 0x0100 << chan;
        /* If channel is disconnecting, do nothing */
@@ -454,6 +474,7 @@ chan_cmd(uint16 dev, uint16 dcmd, uint32 addr)
     /* If no channel device, quick exit */
     if (chan_unit[chan].flags & UNIT_DIS)
         return SCPE_IOERR;
+    chan_wake(chan);
     /* Unit is busy doing something, wait */
     if (chan_flags[chan] & (DEV_SEL|DEV_DISCO|STA_TWAIT|STA_WAIT|STA_ACTIVE))
         return SCPE_BUSY;
@@ -565,6 +586,7 @@ chan_write_char(int chan, uint8 * data, int flags)
 {
     uint8       ch = *data;
 
+    chan_wake(chan);
     sim_debug(DEBUG_DATA, &chan_dev, "write chan %d char %o %d %o %o %o\n", chan,
                *data, caddr[chan], M[caddr[chan]], chan_io_status[chan], flags);
 
@@ -634,6 +656,7 @@ int
 chan_read_char(int chan, uint8 * data, int flags)
 {
 
+    chan_wake(chan);
     sim_debug(DEBUG_DATA, &chan_dev, "read chan %d char %o %d %o %o\n", chan,
                M[caddr[chan]], caddr[chan], chan_io_status[chan], flags);
     /* Return END_RECORD if requested */
@@ -712,6 +735,7 @@ chan9_set_error(int chan, uint32 mask)
     if (chan_flags[chan] & mask)
         return;
     chan_flags[chan] |= mask;
+    chan_wake(chan);
 }
 
 t_stat
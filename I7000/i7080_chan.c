@@ -193,6 +193,7 @@ chan_reset(DEVICE * dptr)
         caddr[i] = 0;
         cmd[i] = 0;
         bcnt[i] = 0;
+        chan_wake(i);
     }
     return chan_set_devs(dptr);
 }
@@ -247,6 +248,7 @@ chan_boot(int32 unit_num, DEVICE * dptr)
     chwait = chan + 1;  /* Force wait for channel */
     chan_flags[chan] |= STA_ACTIVE;
     chan_flags[chan] &= ~STA_PEND;
+    chan_wake(chan);
     cmd[chan] = 0;
     caddr[chan] = 0;
     return SCPE_OK;
@@ -390,12 +392,22 @@ chan_proc()
     int                 unit;
     uint32              addr;
 
+    /* Quick exit if all channels are idle */
+    if (chan_pend == 0)
+        return;
+
     /* Scan channels looking for work */
     for (chan = 0; chan < NUM_CHAN; chan++) {
-        /* Skip if channel is disabled */
-        if (chan_unit[chan].flags & UNIT_DIS)
+        if ((chan_pend & (1 << chan)) == 0)
             continue;
 
+        /* Drop channel from scan if disabled or nothing to do */
+        if ((chan_unit[chan].flags & UNIT_DIS) ||
+            (chan_flags[chan] & (STA_PEND|STA_ACTIVE)) == 0) {
+            chan_pend &= ~(1 << chan);
+            continue;
+        }
+
        /* If channel is disconnecting, do nothing */
         if (chan_flags[chan] & DEV_DISCO)
              continue;
@@ -440,6 +452,7 @@ chan_proc()
                         break;
                  case SCPE_OK:
                         chan_flags[chan2] |= STA_ACTIVE;
+                        chan_wake(chan2);
                         selreg2 &= 0x7fff;
                         chwait = chan2+1;       /* Change wait channel */
                         break;
@@ -788,6 +801,7 @@ chan_cmd(uint16 dev, uint16 dcmd, uint32 addr)
     /* Unit is busy doing something, wait */
     if (chan_flags[chan] & (DEV_SEL| DEV_DISCO|STA_TWAIT|STA_WAIT|STA_ACTIVE))
         return SCPE_BUSY;
+    chan_wake(chan);
 
     /* Ok, try and find the unit */
     caddr[chan] = addr;
@@ -1034,6 +1048,7 @@ chan_write_char(int chan, uint8 * data, int flags)
     int         unit;
     uint16      msk;
 
+    chan_wake(chan);
     /* Based on channel type get next character */
     switch(CHAN_G_TYPE(chan_unit[chan].flags)) {
     case CHAN_754:
@@ -1130,6 +1145,7 @@ chan_read_char(int chan, uint8 * data, int flags)
     /* Check if he write out last data */
     if ((chan_flags[chan] & STA_ACTIVE) == 0)
         return TIME_ERROR;
+    chan_wake(chan);
 
     /* Based on channel type get next character */
     switch(CHAN_G_TYPE(chan_unit[chan].flags)) {
@@ -1236,6 +1252,7 @@ chan9_set_error(int chan, uint32 mask)
     if (chan_flags[chan] & mask)
         return;
     chan_flags[chan] |= mask;
+    chan_wake(chan);
 }
 
 t_stat
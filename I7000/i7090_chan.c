@@ -243,6 +243,7 @@ chan_reset(DEVICE * dptr)
             chan_unit[i].flags |= CHAN_SET;
         chan_flags[i] = 0;
         chan_info[i] = 0;
+        chan_wake(i);
         caddr[i] = 0;
         cmd[i] = 0;
         sms[i] = 0;
@@ -265,6 +266,7 @@ chan_boot(int32 unit_num, DEVICE * dptr)
     UNIT               *uptr = &dptr->units[unit_num];
     int                 chan = UNIT_G_CHAN(uptr->flags);
 
+    chan_wake(chan);
     if (CHAN_G_TYPE(chan_unit[chan].flags) == CHAN_PIO) {
         IC = 0;
     } else {
@@ -324,6 +326,18 @@ bcd_xlat(int chan, int direction)
     assembly[chan] = na;
 }
 
+/* Check if channel has nothing for chan_proc to do */
+static int
+chan_idle(int chan)
+{
+    /* Status flags are only looked at by the CPU */
+    if (chan_flags[chan] & ~(CHS_EOT|CHS_BOT|CHS_EOF|CHS_ERR))
+        return 0;
+    if (chan_info[chan] & CHAINF_START)
+        return 0;
+    return chan_irq[chan] == 0;
+}
+
 /* Execute the next channel instruction. */
 void
 chan_proc()
@@ -333,12 +347,21 @@ chan_proc()
     int                 cmask;
 #endif
 
+    /* Quick exit if all channels are idle */
+    if (chan_pend == 0)
+        return;
+
     /* Scan channels looking for work */
     for (chan = 0; chan < NUM_CHAN; chan++) {
-        /* Skip if channel is disabled */
-        if (chan_unit[chan].flags & UNIT_DIS)
+        if ((chan_pend & (1 << chan)) == 0)
             continue;
 
+        /* Drop channel from scan if disabled or nothing to do */
+        if ((chan_unit[chan].flags & UNIT_DIS) || chan_idle(chan)) {
+            chan_pend &= ~(1 << chan);
+            continue;
+        }
+
         /* If channel is disconnecting, do nothing */
         if (chan_flags[chan] & DEV_DISCO)
             continue;
@@ -1227,6 +1250,7 @@ chan_rst(int chan, int type)
         return;
     if (chan_dev.dctrl & (0x0100 << chan))
         sim_debug(DEBUG_CHAN, &chan_dev, "Reset channel\n");
+    chan_wake(chan);
     /* Clear outstanding traps on reset */
     if (type)
         iotraps &= ~(1 << chan);
@@ -1256,6 +1280,7 @@ chan_cmd(uint16 dev, uint16 dcmd)
     /* If no channel device, quick exit */
     if (chan_unit[chan].flags & UNIT_DIS)
         return SCPE_IOERR;
+    chan_wake(chan);
     /* On 704 device new command aborts current operation */
     if (CHAN_G_TYPE(chan_unit[chan].flags) == CHAN_PIO &&
         (chan_flags[chan] & (DEV_SEL | DEV_DISCO)) == DEV_SEL) {
@@ -1320,6 +1345,7 @@ chan_cmd(uint16 dev, uint16 dcmd)
 int
 chan_start(int chan, uint16 addr)
 {
+    chan_wake(chan);
     /* Hold this command until after channel has disconnected */
     if (chan_flags[chan] & DEV_DISCO)
         return SCPE_BUSY;
@@ -1357,6 +1383,7 @@ chan_start(int chan, uint16 addr)
 int
 chan_load(int chan, uint16 addr)
 {
+    chan_wake(chan);
     if (CHAN_G_TYPE(chan_unit[chan].flags) == CHAN_7909) {
         if (chan_flags[chan] & STA_ACTIVE)
             return SCPE_BUSY;
@@ -1447,6 +1474,7 @@ chan_store_diag(int chan, uint16 loc)
 int
 chan_write(int chan, t_uint64 * data, int flags)
 {
+    chan_wake(chan);
 
     /* Check if last data still not taken */
     if (chan_flags[chan] & DEV_FULL) {
@@ -1490,6 +1518,7 @@ chan_write(int chan, t_uint64 * data, int flags)
 int
 chan_read(int chan, t_uint64 * data, int flags)
 {
+    chan_wake(chan);
 
     /* Return END_RECORD if requested */
     if (flags & DEV_WEOR) {
@@ -1539,6 +1568,8 @@ chan_read(int chan, t_uint64 * data, int flags)
 int
 chan_write_char(int chan, uint8 * data, int flags)
 {
+    chan_wake(chan);
+
     /* If Writing end of record, abort */
     if (chan_flags[chan] & DEV_WEOR) {
         chan_flags[chan] &= ~(DEV_FULL | DEV_WEOR);
@@ -1602,6 +1633,7 @@ chan_write_char(int chan, uint8 * data, int flags)
 int
 chan_read_char(int chan, uint8 * data, int flags)
 {
+    chan_wake(chan);
 
     /* Return END_RECORD if requested */
     if (flags & DEV_WEOR) {
@@ -1672,6 +1704,7 @@ chan9_set_error(int chan, uint32 mask)
     if (chan_flags[chan] & mask)
         return;
     chan_flags[chan] |= mask;
+    chan_wake(chan);
     if (mask & (~((sms[chan] << 5) & (SNS_IMSK ^ SNS_IRQS)))) {
         chan_irq[chan] = 1;
     }
@@ -83,6 +83,10 @@
 #define HIST_SPW     0x2000000
 #define HIST_LPW     0x4000000
 
+#define TLB_SETS     256           /* Sets in TLB, indexed by page */
+#define TLB_WAYS     4             /* Entries in each set */
+#define TLB_SPACES   8             /* Address spaces held in TLB */
+
 uint32       *M = NULL;
 uint8        key[MAXMEMSIZE/2048];
 uint32       regs[16];             /* CPU Registers */
@@ -106,7 +110,15 @@ uint16       irqaddr;              /* Address of IRQ vector */
 uint16       loading;              /* Doing IPL */
 uint8        interval_irq = 0;     /* Interval timer IRQ */
 uint8        dat_en = 0;           /* Translate addresses */
-uint32       tlb[256];             /* Translation look aside buffer */
+uint32       tlb[TLB_SETS][TLB_WAYS]; /* Translation look aside buffer */
+uint8        tlb_next[TLB_SETS];   /* Next way to replace in each set */
+uint32       tlb_sto[TLB_SPACES];  /* Segment table address of each space */
+uint32       tlb_stl[TLB_SPACES];  /* Segment table length of each space */
+uint8        tlb_nsto;             /* Next space to replace */
+uint32       tlb_as;               /* Current space, in TLB_AS position */
+t_uint64     tlb_hits;             /* Translations found in TLB */
+t_uint64     tlb_misses;           /* Translations from tables */
+t_uint64     tlb_purges;           /* Full purges of TLB */
 int          page_shift;           /* Amount to shift for page */
 int          page_index;           /* Mask of page index feild */
 int          page_mask;            /* Mask of bits in page address */
@@ -237,8 +249,10 @@ uint32       idle_stop_tm0;        /* sim_os_msec when start counting for idle t
 #define PTE_VALID   0x00000001     /* table valid */
 
 #define TLB_SEG     0x0001f000     /* Segment address */
+#define TLB_AS      0x00700000     /* Address space of entry */
 #define TLB_VALID   0x80000000     /* Entry valid */
 #define TLB_PHY     0x00000fff     /* Physical page */
+#define TLB_V_AS    20             /* Shift of address space */
 
 #define SEG_MASK    0xfffff000     /* Mask segment */
 
@@ -276,6 +290,7 @@ t_stat cpu_set_size (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_set_idle_stop (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+t_stat cpu_show_tlb (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
 t_stat cpu_help (FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag,
                      const char *cptr);
 const char          *cpu_description (DEVICE *dptr);
@@ -398,6 +413,8 @@ MTAB cpu_mod[] = {
         NULL, "SET CPU IDLESTOP stops cpu after waiting n seconds for IRQ"},
     { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, 0, "HISTORY", "HISTORY",
       &cpu_set_hist, &cpu_show_hist },
+    { MTAB_XTD|MTAB_VDV, 0, "TLB", NULL, NULL, &cpu_show_tlb, NULL,
+      "Show TLB statistics"},
     { 0 }
     };
 
@@ -537,6 +554,55 @@ storepsw(uint32 addr, uint16 ircode)
  *                 seg_mask = 0xfff
  */
 
+/*
+ * Purge all entries and address spaces from the TLB.
+ */
+void
+tlb_purge()
+{
+     memset(tlb, 0, sizeof(tlb));
+     memset(tlb_sto, 0, sizeof(tlb_sto));
+     memset(tlb_stl, 0, sizeof(tlb_stl));
+     tlb_nsto = 0;
+     tlb_as = 0;
+     tlb_sto[0] = seg_addr;
+     tlb_stl[0] = seg_len;
+     tlb_purges++;
+}
+
+/*
+ * Select the TLB address space for the current segment table.
+ * Entries are tagged with the space they were loaded under, so
+ * switching between segment tables does not need a purge.  When
+ * a new table takes over a slot the old entries of it are dropped.
+ * Used when the 370 loads CR1, since a program that changes its
+ * tables must issue PTLB; on the 67 loading CR0 purges instead.
+ */
+void
+tlb_space()
+{
+     int         i, j;
+     uint32      as;
+
+     for (i = 0; i < TLB_SPACES; i++) {
+         if (tlb_sto[i] == (uint32)seg_addr && tlb_stl[i] == seg_len) {
+             tlb_as = i << TLB_V_AS;
+             return;
+         }
+     }
+     tlb_nsto = (tlb_nsto + 1) % TLB_SPACES;
+     tlb_sto[tlb_nsto] = seg_addr;
+     tlb_stl[tlb_nsto] = seg_len;
+     tlb_as = tlb_nsto << TLB_V_AS;
+     as = tlb_as | TLB_VALID;
+     for (i = 0; i < TLB_SETS; i++) {
+         for (j = 0; j < TLB_WAYS; j++) {
+             if ((tlb[i][j] & (TLB_AS|TLB_VALID)) == as)
+                 tlb[i][j] = 0;
+         }
+     }
+}
+
 /*
  * Translate an address from virtual to physical.
  */
@@ -547,6 +613,8 @@ TransAddr(uint32 va, uint32 *pa)
      uint32      page;
      uint32      entry;
      uint32      addr;
+     uint32      *set;
+     int         way;
 
      /* Check address in range */
      va &= AMASK;
@@ -561,19 +629,22 @@ TransAddr(uint32 va, uint32 *pa)
      }
 
      page = (va >> page_shift);
-     seg = (page & 0x1f00) << 4;
+     seg = ((page & 0x1f00) << 4) | tlb_as | TLB_VALID;
      /* Quick check if TLB correct */
-     entry = tlb[page & 0xff];
-     if ((entry & TLB_VALID) != 0 && ((entry ^ seg) & TLB_SEG) == 0) {
-         *pa = (va & page_mask) | ((entry & TLB_PHY) << page_shift);
-         if (*pa >= MEMSIZE) {
-            storepsw(OPPSW, IRC_ADDR);
-            return 1;
+     set = &tlb[page & (TLB_SETS - 1)][0];
+     for (way = 0; way < TLB_WAYS; way++) {
+         entry = set[way];
+         if (((entry ^ seg) & (TLB_VALID|TLB_AS|TLB_SEG)) == 0) {
+             tlb_hits++;
+             *pa = (va & page_mask) | ((entry & TLB_PHY) << page_shift);
+             if (*pa >= MEMSIZE) {
+                storepsw(OPPSW, IRC_ADDR);
+                return 1;
+             }
+             return 0;
          }
-         return 0;
      }
-     /* Clear whatever was in entry */
-     tlb[page & 0xff] = 0;
+     tlb_misses++;
      /* TLB not correct, try loading correct entry */
      seg = (va >> seg_shift) & seg_mask;   /* Segment number to word address */
      page = (va >> page_shift) & page_index;
@@ -658,8 +729,11 @@ TransAddr(uint32 va, uint32 *pa)
      /* Compute correct entry */
      entry >>= pte_shift; /* Move physical to correct spot */
      page = (va >> page_shift);
-     entry |= ((page & 0x1f00) << 4) | TLB_VALID;
-     tlb[page & 0xff] = entry;
+     entry |= ((page & 0x1f00) << 4) | tlb_as | TLB_VALID;
+     /* Replace the next entry of the set in turn */
+     way = tlb_next[page & (TLB_SETS - 1)];
+     tlb_next[page & (TLB_SETS - 1)] = (way + 1) % TLB_WAYS;
+     set[way] = entry;
      *pa = ((va & page_mask) | ((entry & TLB_PHY) << page_shift)) & AMASK;
      if (*pa >= MEMSIZE) {
         storepsw(OPPSW, IRC_ADDR);
@@ -1138,6 +1212,87 @@ WriteHalf(uint32 addr, uint32 data)
      return 0;
 }
 
+/*
+ * Translate the next byte of a storage operand that is processed one
+ * byte at a time in ascending order.  The address is translated and the
+ * key checked when the walk starts or enters a new 2K block, otherwise
+ * the physical address just advances.  Mode is 0 for fetch, 1 for store
+ * and 2 for fetch and store.  Return 1 if failure, 0 if success.
+ */
+int
+NextByte(uint32 addr, uint32 *pa, int mode, int first)
+{
+     addr &= AMASK;
+     if (first || (addr & 0x7ff) == 0) {
+         /* Validate address */
+         if (TransAddr(addr, pa))
+             return 1;
+         if (mode != 1) {
+             if (CheckProtect(*pa, 0))
+                 return 1;
+             /* Update access flag */
+             key[*pa >> 11] |= 0x4;
+         }
+         if (mode != 0) {
+             if (CheckProtect(*pa, 1))
+                 return 1;
+             /* Flag as modified */
+             key[*pa >> 11] |= 0x6;
+         }
+     } else {
+         (*pa)++;
+     }
+
+     /* Check if in storage area */
+     if (mode != 0 && per_en && (cregs[9] & 0x20000000) != 0) {
+         if (cregs[10] <= cregs[11]) {
+            if (addr >= cregs[10] && addr <= cregs[11]) {
+                per_code |= 0x2000;
+            }
+         } else {
+            if (addr >= cregs[11] || addr <= cregs[10]) {
+                per_code |= 0x2000;
+            }
+         }
+     }
+     return 0;
+}
+
+/*
+ * Fetch an entry of a 256 byte TR or TRT table.  The table covers at
+ * most two 2K blocks, each is translated on first use and its physical
+ * base kept in tpa, which the caller sets to all ones beforehand.
+ * Return 1 if failure, 0 if success.
+ */
+int
+TableByte(uint32 table, uint32 index, uint32 tpa[2], uint32 *data)
+{
+     uint32     addr = (table + index) & AMASK;
+     int        blk = (addr & PMASK) != (table & PMASK);
+     uint32     pa;
+
+     if (tpa[blk] == 0xffffffff) {
+         /* Validate address */
+         if (TransAddr(addr, &pa))
+             return 1;
+         if (CheckProtect(pa, 0))
+             return 1;
+         /* Update access flag */
+         key[pa >> 11] |= 0x4;
+         tpa[blk] = pa - (addr & 0x7ff);
+     }
+     pa = tpa[blk] + (addr & 0x7ff);
+     *data = (M[pa >> 2] >> (8 * (3 - (pa & 3)))) & 0xff;
+     return 0;
+}
+
+/*
+ * Get and put a byte at a physical address already checked by NextByte.
+ */
+#define GetByte(pa)     ((M[(pa) >> 2] >> (8 * (3 - ((pa) & 3)))) & 0xff)
+#define PutByte(pa, d)  M[(pa) >> 2] = (M[(pa) >> 2] & ~(0xffu << (8 * (3 - ((pa) & 3))))) | \
+                                       (((uint32)(d) & 0xffu) << (8 * (3 - ((pa) & 3))))
+
 
 t_stat
 sim_instr(void)
@@ -1151,6 +1306,9 @@ sim_instr(void)
     uint32          desth;
     uint32          addr1;       /* Address of 1st source */
     uint32          addr2;       /* Address of 2st source */
+    uint32          pa1, pa2;    /* Physical address of SS operands */
+    uint32          tpa[2];      /* Physical base of TR/TRT table blocks */
+    int             first;       /* First byte of an SS operand */
     uint16          ops[3];      /* Current instruction */
     uint8           op;          /* Opcode of current instruction */
     uint8           fill;        /* Holds fill and other temp flags */
@@ -1215,6 +1373,7 @@ sim_instr(void)
     }
     /* Generate pte index mask */
     page_index = ((~(seg_mask << seg_shift) & ~page_mask) & AMASK) >> page_shift;
+    tlb_space();
     reason = SCPE_OK;
     ilc = 0;
     irq_en |= (loading != 0);
@@ -2316,14 +2475,12 @@ save_dbl:
                                     reg1, addr1, dest, PC, reg);
                         switch (reg1) {
                         case 0x0:     /* Segment table address */
-                                  for (addr2 = 0;
-                                       addr2 < sizeof(tlb)/sizeof(uint32);
-                                       addr2++)
-                                      tlb[addr2] = 0;
                                   if ((dest & 0x3f) != 0)
                                      storepsw(OPPSW, IRC_DATA);
                                   seg_addr = dest & AMASK;
                                   seg_len = (((dest >> 24) & 0xff) + 1) << 4;
+                                  /* The 67 has no PTLB, loading CR0 purges */
+                                  tlb_purge();
                                   break;
                         case 0x4:     /* Extended mask */
                                   cregs[reg] &= 0xfefe0000;
@@ -2514,12 +2671,15 @@ save_dbl:
 
                 if (op == OP_NC || op == OP_OC || op == OP_XC)
                     cc = 0;
+                first = 1;
                 do {
-                   if (ReadByte(addr2, &src1))
+                   if (NextByte(addr2, &pa2, 0, first))
+                       goto supress;
+                   src1 = GetByte(pa2);
+                   if (NextByte(addr1, &pa1, (op == OP_MVC) ? 1 : 2, first))
                        goto supress;
                    if (op != OP_MVC) {
-                       if (ReadByte(addr1, &dest))
-                           goto supress;
+                       dest = GetByte(pa1);
                        switch(op) {
                        case OP_MVZ: dest = (dest & 0x0f) | (src1 & 0xf0); break;
                        case OP_MVN: dest = (dest & 0xf0) | (src1 & 0x0f); break;
@@ -2530,8 +2690,8 @@ save_dbl:
                    } else {
                        dest = src1;
                    }
-                   if (WriteByte(addr1, dest))
-                       goto supress;
+                   PutByte(pa1, dest);
+                   first = 0;
                    addr1++;
                    addr2++;
                    reg--;
@@ -2547,11 +2707,15 @@ save_dbl:
                    }
                 }
                 cc = 0;
+                first = 1;
                 do {
-                    if (ReadByte(addr1, &src1))
+                    if (NextByte(addr1, &pa1, 0, first))
                        goto supress;
-                    if (ReadByte(addr2, &src2))
+                    if (NextByte(addr2, &pa2, 0, first))
                        goto supress;
+                    src1 = GetByte(pa1);
+                    src2 = GetByte(pa2);
+                    first = 0;
                     if (src1 != src2) {
                        if ((uint32)src1 > (uint32)src2)
                           cc = 2;
@@ -2573,13 +2737,16 @@ save_dbl:
                       goto supress;
                    }
                 }
+                first = 1;
+                tpa[0] = tpa[1] = 0xffffffff;
                 do {
-                   if (ReadByte(addr1, &src1))
+                   if (NextByte(addr1, &pa1, 2, first))
                        goto supress;
-                   if (ReadByte(addr2 + (src1 & 0xff), &dest))
-                       goto supress;
-                   if (WriteByte(addr1, dest))
+                   src1 = GetByte(pa1);
+                   if (TableByte(addr2, src1, tpa, &dest))
                        goto supress;
+                   PutByte(pa1, dest);
+                   first = 0;
                    addr1++;
                    reg--;
                 } while (reg != 0xff);
@@ -2594,11 +2761,15 @@ save_dbl:
                    }
                 }
                 cc = 0;
+                first = 1;
+                tpa[0] = tpa[1] = 0xffffffff;
                 do {
-                   if (ReadByte(addr1, &src1))
+                   if (NextByte(addr1, &pa1, 0, first))
                        goto supress;
-                   if (ReadByte(addr2 + (src1 & 0xff), &dest))
+                   src1 = GetByte(pa1);
+                   if (TableByte(addr2, src1, tpa, &dest))
                        goto supress;
+                   first = 0;
                    if (dest != 0) {
                        regs[1] &= 0xff000000;
                        regs[1] |= addr1 & AMASK;
@@ -3242,8 +3413,7 @@ save_dbl:
                                   storepsw(OPPSW, IRC_OPR);
                                   goto supress;
                               }
-                              for (addr2 = 0; addr2 < sizeof(tlb)/sizeof(uint32); addr2++)
-                                   tlb[addr2] = 0;
+                              tlb_purge();
                               break;
                    case 0x10: /* SPX */
                               storepsw(OPPSW, IRC_OPR);
@@ -3500,11 +3670,11 @@ save_dbl:
                         reg1 &= 0xf;
                         addr1 += 4;
                     };
-                    /* Purge TLB if segment pointer updated */
-                    if (temp) {
-                        for (addr2 = 0; addr2 < sizeof(tlb)/sizeof(uint32); addr2++)
-                             tlb[addr2] = 0;
-                    }
+                    /* Switch TLB space if segment pointer updated. Entries
+                       of a table loaded again are kept, as on the 370 only
+                       PTLB drops entries made from changed tables. */
+                    if (temp)
+                        tlb_space();
                 }
                 break;
 
@@ -3629,15 +3799,20 @@ save_dbl:
                        cc = 0;
 
                     /* Preform actual move */
+                    first = 3;
                     while (src1 != 0) {
                         if (src2 == 0) {
                            dest = fill;
                         } else {
-                           if (ReadByte(addr2, &dest))
+                           if (NextByte(addr2, &pa2, 0, first & 2))
                                break;
+                           dest = GetByte(pa2);
+                           first &= ~2;
                         }
-                        if (WriteByte(addr1, dest))
+                        if (NextByte(addr1, &pa1, 1, first & 1))
                             break;
+                        PutByte(pa1, dest);
+                        first &= ~1;
                         if (src2 != 0) {
                            addr2 ++;
                            addr2 &= AMASK;
@@ -3673,18 +3848,23 @@ save_dbl:
                     fill = (src2 >> 24) & 0xff;
                     src2 &= AMASK;
                     cc = 0;
+                    first = 3;
                     while (src1 != 0 || src2 != 0) {
                         if (src1 == 0) {
                            dest = fill;
                         } else {
-                           if (ReadByte(addr1, &dest))
+                           if (NextByte(addr1, &pa1, 0, first & 1))
                                break;
+                           dest = GetByte(pa1);
+                           first &= ~1;
                         }
                         if (src2 == 0) {
                            desth = fill;
                         } else {
-                           if (ReadByte(addr2, &desth))
+                           if (NextByte(addr2, &pa2, 0, first & 2))
                                break;
+                           desth = GetByte(pa2);
+                           first &= ~2;
                         }
                         if (dest != desth) {
                             if ((uint32)dest > (uint32)desth)
@@ -4926,23 +5106,34 @@ lpsw:
 
 /*
  * Load a decimal number into temp storage.
+ * The operand is translated and checked once per 2K storage block
+ * rather than once per byte, in the same order ReadByte would see it.
  * return 1 if error.
  * return 0 if ok.
  */
 int dec_load(uint8 *data, uint32 addr, int len, int *sign)
 {
     uint32   temp;
+    uint32   pa = 0;
     int      i, j;
     int      err = 0;
 
-    addr += len;     /* Point to end */
+    addr = (addr + len) & AMASK;     /* Point to end */
     memset(data, 0, 32);
     j = 0;
     /* Read it into temp backwards */
     for (i = 0; i <= len; i++) {
         int t;
-        if (ReadByte(addr, &temp))
-            return 1;
+        /* Translate on first byte and when entering a new block */
+        if (i == 0 || (addr & 0x7ff) == 0x7ff) {
+            if (TransAddr(addr, &pa))
+                return 1;
+            if (CheckProtect(pa, 0))
+                return 1;
+            /* Update access flag */
+            key[pa >> 11] |= 0x4;
+        }
+        temp = (M[pa >> 2] >> (8 * (3 - (pa & 3)))) & 0xff;
         t = temp & 0xf;
         if (j != 0 && t > 0x9) {
             err = 1;
@@ -4953,8 +5144,10 @@ int dec_load(uint8 *data, uint32 addr, int len, int *sign)
             err = 1;
         }
         data[j++] = t;
-        addr--;
+        addr = (addr - 1) & AMASK;
+        pa--;
     }
+    sim_debug(DEBUG_DATA, &cpu_dev, "RD P=%08x %d\n", (addr + 1) & AMASK, len + 1);
     /* Check if sign valid and return it */
     if (data[0] == 0xB || data[0] == 0xD)
         *sign = 1;
@@ -4972,14 +5165,18 @@ int dec_load(uint8 *data, uint32 addr, int len, int *sign)
 
 /*
  * Store a decimal number into memory storage.
+ * Like dec_load, checks are done once per 2K storage block.
  * return 1 if error.
  * return 0 if ok.
  */
 int dec_store(uint8 *data, uint32 addr, int len, int sign)
 {
     uint32   temp;
+    uint32   mask;
+    uint32   pa = 0;
     int      i, j;
-    addr += len;
+    int      per = per_en && (cregs[9] & 0x20000000) != 0;
+    addr = (addr + len) & AMASK;
 
     if (sign) {
         data[0] = ((flags & ASCII)? 0xb : 0xd);
@@ -4990,10 +5187,33 @@ int dec_store(uint8 *data, uint32 addr, int len, int sign)
     for (i = 0; i <= len; i++) {
         temp = data[j++] & 0xf;
         temp |= (data[j++] & 0xf) << 4;
-        if (WriteByte(addr, temp))
-            return 1;
-        addr--;
+        /* Translate on first byte and when entering a new block */
+        if (i == 0 || (addr & 0x7ff) == 0x7ff) {
+            if (TransAddr(addr, &pa))
+                return 1;
+            if (CheckProtect(pa, 1))
+                return 1;
+            /* Flag as modified */
+            key[pa >> 11] |= 0x6;
+        }
+        /* Check if in storage area */
+        if (per) {
+            if (cregs[10] <= cregs[11]) {
+               if (addr >= cregs[10] && addr <= cregs[11]) {
+                   per_code |= 0x2000;
+               }
+            } else {
+               if (addr >= cregs[11] || addr <= cregs[10]) {
+                   per_code |= 0x2000;
+               }
+            }
+        }
+        mask = 0xffu << (8 * (3 - (pa & 3)));
+        M[pa >> 2] = (M[pa >> 2] & ~mask) | ((temp << (8 * (3 - (pa & 3)))) & mask);
+        addr = (addr - 1) & AMASK;
+        pa--;
     }
+    sim_debug(DEBUG_DATA, &cpu_dev, "WR P=%08x %d\n", (addr + 1) & AMASK, len + 1);
     return 0;
 }
 
@@ -5386,12 +5606,14 @@ cpu_reset (DEVICE *dptr)
     st_key = cc = pmsk = ec_mode = interval_irq = flags = 0;
     dat_en = irq_en = ext_en = per_en = 0;
     clk_state = CLOCK_UNSET;
-    for (i = 0; i < 256; i++)
-       tlb[i] = 0;
     for (i = 0; i < 4096; i++)
        key[i] = 0;
     for (i = 0; i < 16; i++)
        cregs[i] = 0;
+    seg_addr = 0;
+    seg_len = 0;
+    tlb_purge();
+    tlb_hits = tlb_misses = tlb_purges = 0;
     clk_cmp[0] = clk_cmp[1] = 0xffffffff;
     if (Q370) {
         if (clk_state == CLOCK_UNSET) {
@@ -5790,6 +6012,16 @@ cpu_show_hist(FILE * st, UNIT * uptr, int32 val, CONST void *desc)
     return SCPE_OK;
 }
 
+/* Show TLB statistics */
+
+t_stat
+cpu_show_tlb(FILE * st, UNIT * uptr, int32 val, CONST void *desc)
+{
+    fprintf(st, "TLB hits=%" LL_FMT "u misses=%" LL_FMT "u purges=%" LL_FMT "u",
+                tlb_hits, tlb_misses, tlb_purges);
+    return SCPE_OK;
+}
+
 
 t_stat
 cpu_help(FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag, const char *cptr)
@@ -40,6 +40,8 @@
 #define DD_HEIGHT    480                    /* Display height. */
 #define DD_PIXELS    (DD_WIDTH * DD_HEIGHT) /* Total number of pixels. */
 #define DD_CHANNELS  32                     /* Data Disc channels. */
+#define DD_WORDS     (DD_WIDTH / 32)        /* Words per scanline. */
+#define DD_DIRTY     ((DD_HEIGHT + 31) / 32) /* Words of scanline dirty bits. */
 #define DD_COLUMNS   85
 #define FONT_WIDTH   6
 #define FONT_HEIGHT  12
@@ -82,9 +84,11 @@ static uint32 vds_surface[VDS_OUTPUTS][DD_PIXELS];
 static uint32 vds_palette[VDS_OUTPUTS][2];
 static VID_DISPLAY *vds_vptr[VDS_OUTPUTS];
 
-/* There are 32 channels on the Data Disc. */
-static uint8 dd_channel[DD_CHANNELS][DD_PIXELS];
-static uint8 dd_changed[DD_CHANNELS];
+/* There are 32 channels on the Data Disc.  Each is kept as a bitplane,
+   leftmost pixel in the most significant bit, with one dirty bit per
+   scanline. */
+static uint32 dd_channel[DD_CHANNELS][DD_HEIGHT][DD_WORDS];
+static uint32 dd_dirty[DD_CHANNELS][DD_DIRTY];
 static int dd_windows = 1;
 
 static uint8 dd_function_code = 0;
@@ -248,27 +252,46 @@ dd_devio(uint32 dev, uint64 *data) {
     return SCPE_OK;
 }
 
+/* Write up to 32 pixels, taken from the top of bits, to line y of the
+   current channel starting at x. */
 static void
-dd_pixel (int x, int y, uint8 pixel)
+dd_pixels (int x, int y, uint32 bits, int width)
 {
+    uint32 *row;
+    uint32 mask;
+    int shift;
+
     if (x >= DD_WIDTH)
       return;
     if (y >= DD_HEIGHT)
       return;
-    pixel &= 1;
+    if (dd_unit.CHANNEL >= DD_CHANNELS)
+      return;
+    if (x + width > DD_WIDTH)
+      width = DD_WIDTH - x;
+    mask = 0xFFFFFFFF << (32 - width);
+    bits &= mask;
     if (!(dd_function_code & FC_DARK))
-        pixel ^= 1;
+        bits ^= mask;
+    row = &dd_channel[dd_unit.CHANNEL][y][x >> 5];
+    shift = x & 31;
     if (dd_function_code & FC_ADDITIVE)
-        dd_channel[dd_unit.CHANNEL][DD_WIDTH * y + x] |= pixel;
+        row[0] |= bits >> shift;
     else
-        dd_channel[dd_unit.CHANNEL][DD_WIDTH * y + x] = pixel;
-    dd_changed[dd_unit.CHANNEL] = 1;
+        row[0] = (row[0] & ~(mask >> shift)) | (bits >> shift);
+    if (shift + width > 32) {
+        if (dd_function_code & FC_ADDITIVE)
+            row[1] |= bits << (32 - shift);
+        else
+            row[1] = (row[1] & ~(mask << (32 - shift))) | (bits << (32 - shift));
+    }
+    dd_dirty[dd_unit.CHANNEL][y >> 5] |= 1U << (y & 31);
 }
 
 static void
 dd_chargen (uint16 c, int column)
 {
-    int i, j;
+    int i;
     uint8 pixels;
     int line = dd_unit.LINE;
     int field = line & 1;
@@ -281,10 +304,8 @@ dd_chargen (uint16 c, int column)
 
     for (i = 0; i < FONT_HEIGHT-1; i += 2, line += 2) {
         pixels = font[c][i + field];
-        for (j = 0; j < FONT_WIDTH-1; j++) {
-            dd_pixel (6 * column + j, line, pixels >> 4);
-            pixels <<= 1;
-        }
+        dd_pixels (6 * column, line, (uint32)pixels << (32 - (FONT_WIDTH-1)),
+                   FONT_WIDTH-1);
     }
 }
 
@@ -381,17 +402,10 @@ dd_text (uint64 insn)
 static void
 dd_graphics (uint8 data, int column)
 {
-    int i;
-
     sim_debug (DEBUG_CMD, &dd_dev, "GRAPHICS %03o %d@(%d,%d)\n",
                data, dd_unit.CHANNEL, column, dd_unit.LINE);
 
-    column = 8 * column + 4;
-    for (i = 0; i < 8; i++) {
-        dd_pixel (column, dd_unit.LINE, data >> 7);
-        column++;
-        data <<= 1;
-    }
+    dd_pixels (8 * column + 4, dd_unit.LINE, (uint32)data << 24, 8);
 }
 
 static void
@@ -435,7 +449,6 @@ dd_function (uint8 data)
 static void
 dd_command (uint32 command, uint8 data)
 {
-    int i;
     switch (command) {
     case 0:
         dd_execute ("COMMAND: execute");
@@ -450,9 +463,10 @@ dd_command (uint32 command, uint8 data)
         if ((dd_function_code & (FC_GRAPHICS|FC_ERASE)) == (FC_GRAPHICS|FC_ERASE)) {
             sim_debug(DEBUG_CMD, &dd_dev, "COMMAND: erase channel %d\n",
                       dd_unit.CHANNEL);
-            dd_changed[dd_unit.CHANNEL] = 1;
-            for (i = 0; i < DD_PIXELS; i++)
-                dd_channel[dd_unit.CHANNEL][i] = 0;
+            if (dd_unit.CHANNEL < DD_CHANNELS) {
+                memset (dd_channel[dd_unit.CHANNEL], 0, sizeof dd_channel[0]);
+                memset (dd_dirty[dd_unit.CHANNEL], 0xFF, sizeof dd_dirty[0]);
+            }
         }
         break;
     case 3:
@@ -555,11 +569,28 @@ dd_svc (UNIT *uptr)
     return SCPE_OK;
 }
 
+/* Expand one scanline of a channel through the output palette. */
+static void
+dd_expand (uint32 *out, const uint32 *row, uint32 black, uint32 white)
+{
+    uint32 diff = black ^ white;
+    uint32 bits;
+    int i, j;
+
+    /* Branch free so the compiler can vectorize the inner loop. */
+    for (i = 0; i < DD_WORDS; i++, out += 32) {
+        bits = row[i];
+        for (j = 0; j < 32; j++)
+            out[j] = black ^ (diff & (0 - ((bits >> (31 - j)) & 1)));
+    }
+}
+
 static void
 dd_display (int n)
 {
     uint32 selection = vds_selection[n];
     int i, j;
+    int first = DD_HEIGHT, last = -1;
 
     if (selection == 0) {
         sim_debug(DEBUG_DETAIL, &vds_dev, "Output %d displays no channels\n", n);
@@ -570,11 +601,23 @@ dd_display (int n)
     if (!(selection & (selection - 1))) {
         for (i = 0; (selection & 020000000000) == 0; i++)
             selection <<= 1;
-        if (!dd_changed[i] && !vds_changed[n])
+        /* Expand only the changed scanlines, the rest of the surface
+           still holds what was drawn before. */
+        for (j = 0; j < DD_HEIGHT; j++) {
+            if (!vds_changed[n] && (dd_dirty[i][j >> 5] & (1U << (j & 31))) == 0)
+                continue;
+            dd_expand (&vds_surface[n][DD_WIDTH * j], dd_channel[i][j],
+                       vds_palette[n][0], vds_palette[n][1]);
+            if (first > j)
+                first = j;
+            last = j;
+        }
+        if (last < 0)
             return;
-        sim_debug(DEBUG_DETAIL, &vds_dev, "Output %d from channel %d\n", n, i);
-        for (j = 0; j < DD_PIXELS; j++)
-            vds_surface[n][j] = vds_palette[n][dd_channel[i][j]];
+        sim_debug(DEBUG_DETAIL, &vds_dev, "Output %d from channel %d lines %d-%d\n",
+                  n, i, first, last);
+        vid_draw_window (vds_vptr[n], 0, first, DD_WIDTH, last - first + 1,
+                         &vds_surface[n][DD_WIDTH * first]);
     } else {
 #endif
 
@@ -583,7 +626,7 @@ dd_display (int n)
         uint8 pixel = 0;
         for (i = 0; i < DD_CHANNELS; i++, selection <<= 1) {
             if (selection & 020000000000)
-                pixel |= dd_channel[i][j];
+                pixel |= (dd_channel[i][j / DD_WIDTH][(j % DD_WIDTH) >> 5] >> (31 - (j & 31))) & 1;
             vds_surface[n][j] = vds_palette[n][pixel];
         }
     }
@@ -591,7 +634,6 @@ dd_display (int n)
     }
 #endif
 
-    vid_draw_window (vds_vptr[n], 0, 0, DD_WIDTH, DD_HEIGHT, vds_surface[n]);
     vid_refresh_window (vds_vptr[n]);
     sim_debug (DEBUG_DETAIL, &vds_dev, "Refresh window %p\n", vds_vptr[n]);
 }
@@ -602,8 +644,7 @@ vds_svc (UNIT *uptr)
     int i;
     for (i = III_DISPLAYS; i < dd_windows + III_DISPLAYS; i++)
         dd_display (i);
-    for (i = 0; i < DD_CHANNELS; i++)
-        dd_changed[i] = 0;
+    memset (dd_dirty, 0, sizeof dd_dirty);
     for (i = 0; i < VDS_OUTPUTS; i++)
         vds_changed[i] = 0;
 
@@ -629,7 +670,7 @@ dd_reset (DEVICE *dptr)
     if (dptr->flags & DEV_DIS || sim_switches & SWMASK('P')) {
         sim_cancel (&dd_unit);
         memset (dd_channel, 0, sizeof dd_channel);
-        memset (dd_changed, 0, sizeof dd_changed);
+        memset (dd_dirty, 0, sizeof dd_dirty);
         return SCPE_OK;
     }
     if (dptr->flags & DEV_DIS)
@@ -703,6 +744,7 @@ vds_reset (DEVICE *dptr)
             fprintf(stderr, "Window %d is %p\r\n", i, vds_vptr[i]);
             vds_palette[i][0] = vid_map_rgb_window (vds_vptr[i], 0x00, 0x00, 0x00);
             vds_palette[i][1] = vid_map_rgb_window (vds_vptr[i], 0x00, 0xFF, 0x30);
+            vds_changed[i] = 1;
         }
     }
 
@@ -2305,12 +2305,29 @@ t_stat ttyo_svc (UNIT *uptr)
            continue;
        f = 1;
        while (f && not_empty(optr)) {
-           int32 ch = optr->buff[optr->out_ptr];
-           ch = sim_tt_outcvt(ch, TT_GET_MODE (tty_unit[0].flags) | TTUF_KSR);
-           sim_debug(DEBUG_DATA, &tty_dev, "TTY: %d output %o\n", ln, ch);
-           r = tmxr_putc_ln (lp, ch);
-           if (r == SCPE_OK)
+           uint8    buf[sizeof(optr->buff)];
+           size_t   n = 0;
+           size_t   sent;
+           int      ptr = optr->out_ptr;
+
+           /* Send queued characters up to the next unprintable one as a block */
+           while (ptr != optr->in_ptr) {
+               int32 ch = optr->buff[ptr];
+               ch = sim_tt_outcvt(ch, TT_GET_MODE (tty_unit[0].flags) | TTUF_KSR);
+               if (ch < 0)
+                   break;
+               sim_debug(DEBUG_DATA, &tty_dev, "TTY: %d output %o\n", ln, ch);
+               buf[n++] = (uint8)ch;
+               ptr = (ptr + 1) & 0xff;
+           }
+           if (n == 0) {
                inco(optr);
+               continue;
+           }
+           r = tmxr_put_block_ln (lp, buf, n, &sent);
+           optr->out_ptr = (optr->out_ptr + (int)sent) & 0xff;
+           if (r == SCPE_OK)
+               continue;
            else if (r == SCPE_LOST) {
                optr->out_ptr = optr->in_ptr = 0;
                f = 0;
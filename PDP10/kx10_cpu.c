@@ -106,7 +106,18 @@
 #define TMR_QUA         1
 
 
-uint64  M[MAXMEMSIZE];                        /* Memory */
+uint64  *M = NULL;                            /* Memory, allocated at first reset */
+static t_bool cpu_hugepages = FALSE;          /* Memory backed by huge pages */
+#if KI
+#define SMP_HDR         8                     /* Header words in shared memory */
+static SHMEM   *smp_shmem = NULL;             /* Memory shared with other CPU */
+static char    smp_name[CBUFSIZE];            /* Shared memory segment name */
+static uint64  *smp_local = NULL;             /* Own memory while shared */
+static int32   *smp_lock = NULL;              /* Read-pause-write interlock */
+static int32   smp_owner = 0;                 /* Our id in the interlock */
+static int     smp_held = 0;                  /* Interlock held by this CPU */
+static int     smp_stop = 0;                  /* Stopped waiting for interlock */
+#endif
 #if KL | KS
 uint64  FM[128];                              /* Fast memory register */
 #elif KI
@@ -391,6 +402,13 @@ t_stat cpu_reset (DEVICE *dptr);
 t_stat cpu_set_size (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+t_stat cpu_set_hugepages (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
+t_stat cpu_show_hugepages (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+#if KI
+t_stat cpu_set_shared (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
+t_stat cpu_set_noshared (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
+t_stat cpu_show_shared (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+#endif
 #if KI | KL | KS
 t_stat cpu_set_serial (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_serial (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
@@ -638,6 +656,12 @@ MTAB cpu_mod[] = {
 #if KI|KL|KS
     { MTAB_XTD|MTAB_VDV|MTAB_VALR, 0, "SERIAL", "SERIAL",
           &cpu_set_serial, &cpu_show_serial, NULL, "CPU Serial Number" },
+#if KI
+    { MTAB_XTD|MTAB_VDV|MTAB_VALR, 0, "SHARED", "SHARED=name",
+          &cpu_set_shared, &cpu_show_shared, NULL, "Share memory with another KI10 simulator" },
+    { MTAB_XTD|MTAB_VDV, 0, NULL, "NOSHARED",
+          &cpu_set_noshared, NULL, NULL, "Use private memory" },
+#endif
 #if KL
     { UNIT_M_PAGE, 0, "KL10A", "KL10A", NULL, NULL, NULL,
               "Base KL10"},
@@ -685,6 +709,10 @@ MTAB cpu_mod[] = {
 #endif
     { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, 0, "HISTORY", "HISTORY",
       &cpu_set_hist, &cpu_show_hist },
+    { MTAB_XTD|MTAB_VDV, 1, "HUGEPAGES", "HUGEPAGES", &cpu_set_hugepages,
+      &cpu_show_hugepages, NULL, "Back memory with huge pages when the host allows" },
+    { MTAB_XTD|MTAB_VDV, 0, NULL, "NOHUGEPAGES", &cpu_set_hugepages,
+      NULL, NULL, "Back memory with normal host pages" },
     { 0 }
     };
 
@@ -2297,7 +2325,7 @@ int Mem_read(int flag, int cur_context, int fetch, int mod) {
             check_apr_irq();
             return 1;
         }
-        if (sim_brk_summ && sim_brk_test(addr, SWMASK('R')))
+        if (sim_brk_watch(addr, SWMASK('R')))
             watch_stop = 1;
         sim_interval--;
         MB = M[addr];
@@ -2328,7 +2356,7 @@ int Mem_write(int flag, int cur_context) {
         UPDATE_MI(AB);
     } else {
         if (modify) {
-            if (sim_brk_summ && sim_brk_test(last_addr, SWMASK('W')))
+            if (sim_brk_watch(last_addr, SWMASK('W')))
                 watch_stop = 1;
             M[last_addr] = MB;
             UPDATE_MI(last_addr);
@@ -2343,7 +2371,7 @@ int Mem_write(int flag, int cur_context) {
             check_apr_irq();
             return 1;
         }
-        if (sim_brk_summ && sim_brk_test(addr, SWMASK('W')))
+        if (sim_brk_watch(addr, SWMASK('W')))
             watch_stop = 1;
         sim_interval--;
         M[addr] = MB;
@@ -2845,7 +2873,7 @@ int Mem_read(int flag, int cur_context, int fetch, int mod) {
             irq_flags |= NXM_MEM;
             return 1;
         }
-        if (sim_brk_summ && sim_brk_test(AB, SWMASK('R')))
+        if (sim_brk_watch(AB, SWMASK('R')))
             watch_stop = 1;
         sim_interval--;
         MB = M[addr];
@@ -2885,7 +2913,7 @@ int Mem_write(int flag, int cur_context) {
         UPDATE_MI(AB);
     } else {
         if (modify) {
-            if (sim_brk_summ && sim_brk_test(last_addr, SWMASK('W')))
+            if (sim_brk_watch(last_addr, SWMASK('W')))
                 watch_stop = 1;
             M[last_addr] = MB;
             UPDATE_MI(last_addr);
@@ -2898,7 +2926,7 @@ int Mem_write(int flag, int cur_context) {
             irq_flags |= NXM_MEM;
             return 1;
         }
-        if (sim_brk_summ && sim_brk_test(AB, SWMASK('W')))
+        if (sim_brk_watch(AB, SWMASK('W')))
             watch_stop = 1;
         sim_interval--;
         M[addr] = MB;
@@ -3251,6 +3279,43 @@ void   set_reg(int reg, uint64 value) {
         FM[reg & 017] = value;
 }
 
+/*
+ * When memory is shared with a second KI10 the words are aligned host
+ * words, so each store is seen whole by the other processor. A read
+ * pause write cycle takes the interlock in the header of the segment
+ * and holds it until the write, so AOSE style locks work between the
+ * two processors just as with the memory bus.
+ *
+ * The interlock holds the process id of its owner. Every so often a
+ * waiting CPU checks that the owner still exists, and clears the
+ * interlock if it has gone. A stop request ends the wait; the
+ * instruction is then restarted from the beginning, as after a page
+ * failure. Interrupt instructions keep waiting, they can't be restarted.
+ */
+static int smp_interlock() {
+    int32   owner;
+    int     n;
+
+    for (n = 1; !sim_shmem_atomic_cas (smp_lock, 0, smp_owner); n++) {
+        if ((n & 0xffff) != 0)
+            continue;
+        owner = *(volatile int32 *)smp_lock;
+        if (owner != 0 && !sim_shmem_pid_alive (owner))
+            (void)sim_shmem_atomic_cas (smp_lock, owner, 0);
+        else if (stop_cpu && !pi_cycle) {
+            smp_stop = 1;
+            return 0;
+        }
+    }
+    smp_held = 1;
+    return 1;
+}
+
+static void smp_release() {
+    smp_held = 0;
+    (void)sim_shmem_atomic_cas (smp_lock, smp_owner, 0);
+}
+
 int Mem_read(int flag, int cur_context, int fetch, int mod) {
     t_addr addr;
 
@@ -3282,9 +3347,11 @@ read:
             check_apr_irq();
             return 1;
         }
-        if (sim_brk_summ && sim_brk_test(AB, SWMASK('R')))
+        if (sim_brk_watch(AB, SWMASK('R')))
             watch_stop = 1;
         sim_interval--;
+        if (mod && smp_lock != NULL && !smp_held && !smp_interlock())
+            return 1;
         MB = M[addr];
         modify = mod;
         last_addr = addr;
@@ -3322,9 +3389,11 @@ int Mem_write(int flag, int cur_context) {
         UPDATE_MI(AB);
     } else {
         if (modify) {
-            if (sim_brk_summ && sim_brk_test(last_addr, SWMASK('W')))
+            if (sim_brk_watch(last_addr, SWMASK('W')))
                 watch_stop = 1;
             M[last_addr] = MB;
+            if (smp_held)
+                smp_release();
             UPDATE_MI(last_addr);
             modify = 0;
             return 0;
@@ -3337,7 +3406,7 @@ write:
             check_apr_irq();
             return 1;
         }
-        if (sim_brk_summ && sim_brk_test(AB, SWMASK('W')))
+        if (sim_brk_watch(AB, SWMASK('W')))
             watch_stop = 1;
          sim_interval--;
         M[addr] = MB;
@@ -3566,7 +3635,7 @@ int Mem_read_its(int flag, int cur_context, int fetch, int mod) {
             check_apr_irq();
             return 1;
         }
-        if (sim_brk_summ && sim_brk_test(AB, SWMASK('R')))
+        if (sim_brk_watch(AB, SWMASK('R')))
             watch_stop = 1;
         sim_interval--;
         MB = M[addr];
@@ -3598,7 +3667,7 @@ int Mem_write_its(int flag, int cur_context) {
         UPDATE_MI(AB);
     } else {
         if (modify) {
-            if (sim_brk_summ && sim_brk_test(last_addr, SWMASK('W')))
+            if (sim_brk_watch(last_addr, SWMASK('W')))
                 watch_stop = 1;
             M[last_addr] = MB;
             UPDATE_MI(last_addr);
@@ -3633,7 +3702,7 @@ int Mem_write_its(int flag, int cur_context) {
             check_apr_irq();
             return 1;
         }
-        if (sim_brk_summ && sim_brk_test(AB, SWMASK('W')))
+        if (sim_brk_watch(AB, SWMASK('W')))
             watch_stop = 1;
         sim_interval--;
         M[addr] = MB;
@@ -3931,7 +4000,7 @@ int Mem_read_bbn(int flag, int cur_context, int fetch, int mod) {
         check_apr_irq();
         return 1;
     }
-    if (sim_brk_summ && sim_brk_test(AB, SWMASK('R')))
+    if (sim_brk_watch(AB, SWMASK('R')))
         watch_stop = 1;
     sim_interval--;
     MB = M[addr];
@@ -3959,7 +4028,7 @@ int Mem_write_bbn(int flag, int cur_context) {
         return 0;
     }
     if (modify) {
-        if (sim_brk_summ && sim_brk_test(last_addr, SWMASK('W')))
+        if (sim_brk_watch(last_addr, SWMASK('W')))
             watch_stop = 1;
         M[last_addr] = MB;
         UPDATE_MI(AB);
@@ -3978,7 +4047,7 @@ int Mem_write_bbn(int flag, int cur_context) {
         check_apr_irq();
         return 1;
     }
-    if (sim_brk_summ && sim_brk_test(AB, SWMASK('W')))
+    if (sim_brk_watch(AB, SWMASK('W')))
         watch_stop = 1;
     sim_interval--;
     M[addr] = MB;
@@ -4047,7 +4116,7 @@ int Mem_read_waits(int flag, int cur_context, int fetch, int mod) {
         check_apr_irq();
         return 1;
     }
-    if (sim_brk_summ && sim_brk_test(AB, SWMASK('R')))
+    if (sim_brk_watch(AB, SWMASK('R')))
         watch_stop = 1;
     sim_interval--;
     MB = M[addr];
@@ -4076,7 +4145,7 @@ int Mem_write_waits(int flag, int cur_context) {
         return 0;
     }
     if (modify) {
-        if (sim_brk_summ && sim_brk_test(last_addr, SWMASK('W')))
+        if (sim_brk_watch(last_addr, SWMASK('W')))
             watch_stop = 1;
         M[last_addr] = MB;
         modify = 0;
@@ -4090,7 +4159,7 @@ int Mem_write_waits(int flag, int cur_context) {
         check_apr_irq();
         return 1;
     }
-    if (sim_brk_summ && sim_brk_test(AB, SWMASK('W')))
+    if (sim_brk_watch(AB, SWMASK('W')))
         watch_stop = 1;
     sim_interval--;
     M[addr] = MB;
@@ -4137,7 +4206,7 @@ int Mem_read_ka(int flag, int cur_context, int fetch, int mod) {
             check_apr_irq();
             return 1;
         }
-        if (sim_brk_summ && sim_brk_test(AB, SWMASK('R')))
+        if (sim_brk_watch(AB, SWMASK('R')))
             watch_stop = 1;
         sim_interval--;
         MB = M[addr];
@@ -4168,7 +4237,7 @@ int Mem_write_ka(int flag, int cur_context) {
             check_apr_irq();
             return 1;
         }
-        if (sim_brk_summ && sim_brk_test(AB, SWMASK('W')))
+        if (sim_brk_watch(AB, SWMASK('W')))
             watch_stop = 1;
         sim_interval--;
         M[addr] = MB;
@@ -4310,7 +4379,7 @@ int Mem_read(int flag, int cur_context, int fetch, int mod) {
             check_apr_irq();
             return 1;
         }
-        if (sim_brk_summ && sim_brk_test(AB, SWMASK('R')))
+        if (sim_brk_watch(AB, SWMASK('R')))
             watch_stop = 1;
         MB = M[addr];
     }
@@ -4341,7 +4410,7 @@ int Mem_write(int flag, int cur_context) {
             check_apr_irq();
             return 1;
         }
-        if (sim_brk_summ && sim_brk_test(AB, SWMASK('W')))
+        if (sim_brk_watch(AB, SWMASK('W')))
             watch_stop = 1;
         M[addr] = MB;
     }
@@ -4433,6 +4502,10 @@ int Mem_write_word(t_addr addr, uint64 *data, int ept)
  * Function to determine number of leading zero bits in a work
  */
 int nlzero(uint64 w) {
+#if defined(__GNUC__)
+    if (w == 0) return 36;
+    return __builtin_clzll(w) - 28;
+#else
     int n = 0;
     if (w == 0) return 36;
     if ((w & 00777777000000LL) == 0) { n += 18; w <<= 18; }
@@ -4442,8 +4515,103 @@ int nlzero(uint64 w) {
     if ((w & 00600000000000LL) == 0) { n ++;    w <<= 1;  }
     if ((w & 00400000000000LL) == 0) { n ++; }
     return n;
+#endif
 }
 
+/*
+ * Arithmetic kernels used in place of the bit serial loops for the
+ * multiply and divide instructions. Callers only use these for operands
+ * where the loops produce the mathematical result, the edge cases still
+ * go through the original loops.
+ */
+#if defined(__GNUC__) && defined(__SIZEOF_INT128__)
+#define HAVE_UINT128  1
+typedef unsigned __int128 uint128;
+#endif
+
+/*
+ * Divide the 70 bit magnitude hi,lo by d. hi must be less than d, so
+ * the quotient fits in 35 bits. Done in two 18 bit steps to keep inside
+ * of 64 bit arithmetic.
+ */
+static void
+div_70_36(uint64 hi, uint64 lo, uint64 d, uint64 *quo, uint64 *rem)
+{
+    uint64   n, q;
+
+    n = (hi << 17) | (lo >> 18);
+    q = n / d;
+    n = ((n % d) << 18) | (lo & RMASK);
+    *quo = (q << 18) | (n / d);
+    *rem = n % d;
+}
+
+#if !PDP6
+/*
+ * Count the number of places the floating point working fraction must
+ * be shifted left until bits FPSBIT, FPNBIT and FP1BIT differ. Returns
+ * -1 if bits 62 through 0 are all the same, caller must handle that.
+ */
+static int
+fp_nshift(uint64 w)
+{
+    uint64   x = w & (FPFMASK ^ FPHBIT);
+    int      n;
+
+    if (w & FPSBIT)
+        x ^= FPFMASK ^ FPHBIT;
+    if (x == 0)
+        return -1;
+#if defined(__GNUC__)
+    n = __builtin_clzll(x) - 1;
+#else
+    for (n = 0; (x & FPSBIT) == 0; n++)
+        x <<= 1;
+#endif
+    return (n > 2) ? n - 2 : 0;
+}
+#endif
+
+#if HAVE_UINT128 && (KL | KS)
+/*
+ * Multiply two 70 bit magnitudes, result returned as four 35 bit
+ * words with the high order word first. The high order word gets
+ * an extra bit for the 2**70 * 2**70 case.
+ */
+static void
+mul_70_70(uint64 ah, uint64 al, uint64 bh, uint64 bl, uint64 *w)
+{
+    uint128  t;
+
+    t = (uint128)al * bl;
+    w[3] = (uint64)t & CMASK;
+    t = (t >> 35) + (uint128)ah * bl + (uint128)al * bh;
+    w[2] = (uint64)t & CMASK;
+    t = (t >> 35) + (uint128)ah * bh;
+    w[1] = (uint64)t & CMASK;
+    w[0] = (uint64)(t >> 35);
+}
+
+/*
+ * Divide the 140 bit magnitude in w[0..3] by the 70 bit magnitude dh,dl.
+ * The high 70 bits of the dividend must be less than the divisor.
+ */
+static void
+div_140_70(uint64 *w, uint64 dh, uint64 dl, uint64 *q, uint64 *r)
+{
+    uint128  d = ((uint128)dh << 35) | dl;
+    uint128  n;
+
+    n = (((((uint128)w[0]) << 35) | w[1]) << 35) | w[2];
+    q[0] = (uint64)(n / d);
+    n = ((n % d) << 35) | w[3];
+    q[1] = (uint64)(n / d);
+    n %= d;
+    r[0] = (uint64)(n >> 35);
+    r[1] = (uint64)n & CMASK;
+}
+#endif
+
 t_stat sim_instr (void)
 {
 t_stat reason;
@@ -4508,6 +4676,10 @@ if ((reason = build_dev_tab ()) != SCPE_OK)            /* build, chk dib_tab */
    watch_stop = 0;
 
    while ( reason == 0) {                                /* loop until ABORT */
+#if KI
+      if (smp_held)                                      /* no write after read */
+         smp_release();
+#endif
       AIO_CHECK_EVENT;                                   /* queue async events */
       if (sim_interval <= 0) {                           /* check clock queue */
          if ((reason = sim_process_event()) != SCPE_OK) {/* error?  stop sim */
@@ -5383,7 +5555,19 @@ unasign:
               if (SCAD > 0) {  /* Align numbers */
                   if (SCAD > 64) /* Outside range */
                       AR = 0;
-                  else {
+                  else if (((AR & FPHBIT) != 0) == ((AR & FPSBIT) != 0)) {
+                      /* Shift out to MQ in one step */
+                      if (SCAD > 36)
+                          MQ = (AR >> (SCAD - 36)) & FMASK;
+                      else
+                          MQ = (AR << (36 - SCAD)) & FMASK;
+                      if (SCAD > 63)
+                          SCAD = 63;
+                      if (AR & FPHBIT)
+                          AR = ~((~AR) >> SCAD);
+                      else
+                          AR >>= SCAD;
+                  } else {
                       while (SCAD > 0) {
                           MQ >>= 1;
                           if (AR & 1)
@@ -5497,6 +5681,15 @@ dpnorm:
               SC = SC + FE - 0200;
               ARX = 0;
               /* Do multiply */
+#if HAVE_UINT128
+              {
+                  uint128  p = (uint128)AR * (BR & (FPSBIT - 1));
+
+                  /* MQ holds product bits 35 to 61 */
+                  ARX = (uint64)(p >> 62);
+                  MQ = (((uint64)(p >> 35)) & 0777777777LL) << 8;
+              }
+#else
               for (FE = 0; FE < 62; FE++) {
                   if (FE == 35)  /* Clear MQ so it has correct lower product digits */
                      MQ = 0;
@@ -5508,6 +5701,7 @@ dpnorm:
                   ARX >>= 1;
                   BR >>= 1;
               }
+#endif
               AR = ARX;
               /* Make result negative if needed */
               if (flag1) {
@@ -5821,6 +6015,17 @@ dpnorm:
               BRX &= CMASK; /* Clear sign of BX */
               ARX &= CMASK;
               /* Compute product */
+#if HAVE_UINT128
+              {
+                  uint64   w[4];
+
+                  mul_70_70(AR, ARX, BR, BRX, w);
+                  AD = w[0];
+                  ADX = w[1];
+                  BR = w[2];
+                  BRX = w[3];
+              }
+#else
               for (SC = 70; SC >= 0; SC--) {
                   /* Shift MQ,MB,BR,BX right one */
                   f = (BRX & 1);
@@ -5840,6 +6045,7 @@ dpnorm:
                      ADX &= CMASK;
                   }
               }
+#endif
               /* If minus, negate whole thing */
               if (flag1) {
                    BRX = CCM(BRX) + 1;   /* Low */
@@ -5927,6 +6133,21 @@ dpnorm:
                    break;
               }
               /* Do divide */
+#if HAVE_UINT128
+              if (((AR | BR) & SMASK) == 0) {
+                  uint64   w[4], q[2], r[2];
+
+                  w[0] = AR;
+                  w[1] = ARX;
+                  w[2] = MB;
+                  w[3] = MQ;
+                  div_140_70(w, BR, BRX & CMASK, q, r);
+                  MB = q[0];
+                  MQ = q[1];
+                  AR = r[0];
+                  ARX = r[1];
+              } else
+#endif
               for (SC = 70; SC > 0; SC--) {
                   AR <<= 1;
                   ARX <<= 1;
@@ -6968,6 +7189,13 @@ fnorm:
 #endif
                   if (IR != 0130 && IR != 0247) {   /* !UFA and WAITS FIX */
 fnormx:
+#if !PDP6
+                      /* Skip redundant sign bits in one shift */
+                      if ((f = fp_nshift(AR)) > 0) {
+                          SC -= f;
+                          AR <<= f;
+                      }
+#endif
                       while (AR != 0 && ((AR & FPSBIT) != 0) == ((AR & FPNBIT) != 0) &&
                              ((AR & FPNBIT) != 0) == ((AR & FP1BIT) != 0)) {
                           SC --;
@@ -8140,7 +8368,13 @@ mul_done:
                   break;      /* Done */
               }
 
-              while (SC != 0) {
+              if ((AR & SMASK) == 0) {
+                  /* Divide magnitudes, remainder to AR, quotient to MQ */
+                  AD = (BR & SMASK) ? (CM(BR) + 1) & FMASK : BR;
+                  div_70_36(AR, MQ >> 1, AD, &MQ, &AR);
+              } else {
+                  /* Only for dividend of -2**70 and divisor of zero */
+                  while (SC != 0) {
                       if (((BR & SMASK) != 0) ^ ((MQ & 01) != 0))
                            AD = (AR + CM(BR) + 1);
                       else
@@ -8150,20 +8384,21 @@ mul_done:
                       MQ = (MQ << 1) & FMASK;
                       MQ |= (AD & SMASK) == 0;
                       SC--;
-              }
-              if (((BR & SMASK) != 0) ^ ((MQ & 01) != 0))
-                  AD = (AR + CM(BR) + 1);
-              else
-                  AD = (AR + BR);
-              AR = AD & FMASK;
-              MQ = (MQ << 1) & FMASK;
-              MQ |= (AD & SMASK) == 0;
-              if (AR & SMASK) {
-                   if (BR & SMASK)
-                        AD = (AR + CM(BR) + 1) & FMASK;
-                   else
-                        AD = (AR + BR) & FMASK;
-                   AR = AD;
+                  }
+                  if (((BR & SMASK) != 0) ^ ((MQ & 01) != 0))
+                      AD = (AR + CM(BR) + 1);
+                  else
+                      AD = (AR + BR);
+                  AR = AD & FMASK;
+                  MQ = (MQ << 1) & FMASK;
+                  MQ |= (AD & SMASK) == 0;
+                  if (AR & SMASK) {
+                       if (BR & SMASK)
+                            AD = (AR + CM(BR) + 1) & FMASK;
+                       else
+                            AD = (AR + BR) & FMASK;
+                       AR = AD;
+                  }
               }
 
               if (flag1)
@@ -12035,6 +12270,13 @@ fetch_opr:
 
 last:
     modify = 0;
+#if KI
+    if (smp_stop) {               /* Stopped waiting for the interlock */
+        smp_stop = 0;
+        reason = SCPE_STOP;
+        break;                    /* PC still addresses the instruction */
+    }
+#endif
 #if BBN
     if (QBBN && page_fault) {
         page_fault = 0;
@@ -12312,6 +12554,10 @@ last:
 #if ITS
         if (QITS)
             load_quantum();
+#endif
+#if KI
+        if (smp_held)
+            smp_release();
 #endif
         RUN = 0;
         return SCPE_STEP;
@@ -12319,6 +12565,10 @@ last:
 }
 /* Should never get here */
 RUN = 0;
+#if KI
+if (smp_held)
+    smp_release();
+#endif
 #if ITS
 if (QITS)
     load_quantum();
@@ -13634,6 +13884,11 @@ t_stat cpu_reset (DEVICE *dptr)
     t_stat       r = SCPE_OK;
     static int   initialized = 0;
 
+    if (M == NULL) {
+        M = (uint64 *)sim_memory_alloc ((size_t)MAXMEMSIZE * sizeof (*M));
+        if (M == NULL)
+            return SCPE_MEM;
+    }
     if (!initialized) {
          initialized = 1;
 #if PIDP10
@@ -13810,7 +14065,11 @@ t_stat cpu_set_size (UNIT *uptr, int32 sval, CONST char *cptr, void *desc)
 {
 int32 i;
 int32 val = (int32)sval;
+t_bool release = TRUE;
 
+#if KI
+release = (smp_shmem == NULL);            /* Shared words belong to both CPUs */
+#endif
 if ((val <= 0) || ((val * 16 * 1024) > MAXMEMSIZE))
     return SCPE_ARG;
 val = val * 16 * 1024;
@@ -13820,13 +14079,47 @@ if (val < (int32)MEMSIZE) {
         mc = mc | M[i];
     if ((mc != 0) && (!get_yn ("Really truncate memory [N]?", FALSE)))
         return SCPE_OK;
-}
-for (i = (int32)MEMSIZE; i < val; i++)
-    M[i] = 0;
+    if (release)
+        sim_memory_release (&M[val], ((int32)MEMSIZE - val) * sizeof (*M));
+} else if (release)
+    sim_memory_release (&M[MEMSIZE], (val - (int32)MEMSIZE) * sizeof (*M));
 cpu_unit[0].capac = (uint32)val;
 return SCPE_OK;
 }
 
+/* Huge page backing for memory */
+
+t_stat cpu_set_hugepages (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
+{
+t_stat r;
+
+if (cptr != NULL)
+    return SCPE_ARG;
+if (M == NULL)
+    return SCPE_IERR;
+#if KI
+if (smp_shmem != NULL)                  /* M is the shared segment */
+    return sim_messagef (SCPE_NOFNC, "Memory is shared as %s\n", smp_name);
+#endif
+r = sim_memory_hugepages (M, (size_t)MAXMEMSIZE * sizeof (*M), (t_bool)val);
+if (r != SCPE_OK)
+    return r;
+cpu_hugepages = (t_bool)val;
+return SCPE_OK;
+}
+
+t_stat cpu_show_hugepages (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
+{
+#if KI
+if (smp_shmem != NULL) {                /* Private memory is not in use */
+    fprintf (st, "NOHUGEPAGES");
+    return SCPE_OK;
+    }
+#endif
+fprintf (st, cpu_hugepages ? "HUGEPAGES" : "NOHUGEPAGES");
+return SCPE_OK;
+}
+
 #if !KS
 /* Build device dispatch table */
 t_bool build_dev_tab (void)
@@ -14005,6 +14298,63 @@ return SCPE_OK;
 }
 #endif
 
+#if KI
+/* Share memory with another KI10 */
+t_stat cpu_set_shared (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
+{
+void *base;
+int32 owner;
+t_stat r;
+
+if ((cptr == NULL) || (*cptr == '\0'))
+    return SCPE_ARG;
+if (smp_shmem != NULL)
+    return sim_messagef (SCPE_ALATT, "Memory already shared as %s\n", smp_name);
+if (M == NULL)
+    return SCPE_IERR;
+r = sim_shmem_open (cptr, (SMP_HDR + (size_t)MAXMEMSIZE) * sizeof (*M), &smp_shmem, &base);
+if (r != SCPE_OK)
+    return r;
+strlcpy (smp_name, cptr, sizeof (smp_name));
+smp_local = M;
+smp_lock = (int32 *)base;
+smp_owner = sim_shmem_pid ();
+owner = *(volatile int32 *)smp_lock;        /* Left by a CPU that died? */
+if ((owner == smp_owner) || ((owner != 0) && !sim_shmem_pid_alive (owner)))
+    (void)sim_shmem_atomic_cas (smp_lock, owner, 0);
+M = (uint64 *)base + SMP_HDR;
+return SCPE_OK;
+}
+
+/* Return to private memory */
+t_stat cpu_set_noshared (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
+{
+if (cptr != NULL)
+    return SCPE_ARG;
+if (smp_shmem == NULL)
+    return SCPE_OK;
+(void)sim_shmem_atomic_cas (smp_lock, smp_owner, 0);
+M = smp_local;
+smp_local = NULL;
+smp_lock = NULL;
+smp_held = 0;
+smp_stop = 0;
+sim_shmem_close (smp_shmem);
+smp_shmem = NULL;
+return SCPE_OK;
+}
+
+/* Show shared memory */
+t_stat cpu_show_shared (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
+{
+if (smp_shmem == NULL)
+    fprintf (st, "NOSHARED");
+else
+    fprintf (st, "SHARED=%s", smp_name);
+return SCPE_OK;
+}
+#endif
+
 /* Set history */
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 {
@@ -14116,6 +14466,16 @@ cpu_help(FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag, const char *cptr)
     fprintf(st, "To stop the cpu use the command:\n\n");
     fprintf(st, "    sim> SET CTY STOP\n\n");
     fprintf(st, "This will write a 1 to location %03o, causing TOPS10 to stop\n", CTY_SWITCH);
+#if KI
+    fprintf(st, "\nTwo KI10 simulators can run as a dual processor system, each on\n");
+    fprintf(st, "its own host processor, by sharing memory. Give each CPU its own\n");
+    fprintf(st, "serial number and the same memory name, and leave the I/O devices\n");
+    fprintf(st, "to one of them:\n\n");
+    fprintf(st, "    sim> SET CPU SERIAL=514\n");
+    fprintf(st, "    sim> SET CPU SHARED=ki10mem\n\n");
+    fprintf(st, "The memory contents are those of the shared segment, so load the\n");
+    fprintf(st, "monitor after giving the SHARED command.\n");
+#endif
     fprint_set_help(st, dptr);
     fprint_show_help(st, dptr);
     return SCPE_OK;
@@ -626,6 +626,8 @@ void    rh_writecw(struct rh_if *rh, int nxm);
 void    rh_finish_op(struct rh_if *rh, int flags);
 int     rh_read(struct rh_if *rh);
 int     rh_write(struct rh_if *rh);
+int     rh_read_block(struct rh_if *rh, t_uint64 *buf, int count, int *done);
+int     rh_write_block(struct rh_if *rh, t_uint64 *buf, int count, int *done);
 #else
 extern t_stat (*dev_tab[128])(uint32 dev, t_uint64 *data);
 
@@ -724,6 +726,8 @@ void    rh_writecw(struct rh_if *rh, int nxm);
 void    rh_finish_op(struct rh_if *rh, int flags);
 int     rh_read(struct rh_if *rh);
 int     rh_write(struct rh_if *rh);
+int     rh_read_block(struct rh_if *rh, t_uint64 *buf, int count, int *done);
+int     rh_write_block(struct rh_if *rh, t_uint64 *buf, int count, int *done);
 
 
 /* Console lights. */
@@ -828,7 +832,7 @@ extern t_bool sim_idle_enab;
 #if !KS
 extern struct rh_dev rh[];
 #endif
-extern t_uint64   M[MAXMEMSIZE];
+extern t_uint64   *M;
 extern t_uint64   FM[];
 extern uint32   PC;
 extern uint32   FLAGS;
@@ -66,6 +66,43 @@ static struct disk_formats fmts[] = {
     {0, 0},
 };
 
+/*
+ * Units attached with -S keep the container mapped in uptr->DISK_MAP.
+ * The mapping is shared with every other simulator using the same base
+ * image, writes go to copy-on-write pages private to this simulator.
+ * The overlay covers the whole drive, so sectors past the end of a
+ * short container can still be written.
+ */
+struct disk_map {
+    SHMEM       *shmem;
+    uint8       *base;
+    size_t      size;
+};
+
+/* Copy from the mapped container, returns bytes available */
+static size_t
+disk_map_read(struct disk_map *map, void *buf, t_offset pos, size_t len)
+{
+    if (pos >= (t_offset)map->size)
+        return 0;
+    if (len > (size_t)(map->size - pos))
+        len = (size_t)(map->size - pos);
+    memcpy(buf, map->base + pos, len);
+    return len;
+}
+
+/* Copy into the private overlay, which ends with the drive */
+static size_t
+disk_map_write(struct disk_map *map, const void *buf, t_offset pos, size_t len)
+{
+    if (pos >= (t_offset)map->size)
+        return 0;
+    if (len > (size_t)(map->size - pos))
+        len = (size_t)(map->size - pos);
+    memcpy(map->base + pos, buf, len);
+    return len;
+}
+
 t_stat 
 disk_read(UNIT *uptr, uint64 *buffer, int sector, int wps)
 {
@@ -75,19 +112,30 @@ disk_read(UNIT *uptr, uint64 *buffer, int sector, int wps)
     int      wp;
     uint64   temp;
     uint8    conv_buff[2048];
+    struct disk_map *map = (struct disk_map *)uptr->DISK_MAP;
     switch(GET_FMT(uptr->flags)) {
     case SIMH:
             da = sector * wps;
-            (void)sim_fseek(uptr->fileref, da * sizeof(uint64), SEEK_SET);
-            wc = sim_fread (buffer, sizeof(uint64), wps, uptr->fileref);
+            if (map != NULL) {
+                wc = (int)(disk_map_read(map, buffer, (t_offset)da * sizeof(uint64),
+                                         wps * sizeof(uint64)) / sizeof(uint64));
+                sim_buf_swap_data (buffer, sizeof(uint64), wc);
+            } else {
+                (void)sim_fseek(uptr->fileref, da * sizeof(uint64), SEEK_SET);
+                wc = sim_fread (buffer, sizeof(uint64), wps, uptr->fileref);
+            }
             while (wc < wps)
                 buffer[wc++] = 0;
             break;
     case DBD9:
             bc = (wps / 2) * 9;
             da = sector * bc;
-            (void)sim_fseek(uptr->fileref, da, SEEK_SET);
-            wc = sim_fread (&conv_buff, 1, bc, uptr->fileref);
+            if (map != NULL) {
+                wc = (int)disk_map_read(map, conv_buff, (t_offset)da, bc);
+            } else {
+                (void)sim_fseek(uptr->fileref, da, SEEK_SET);
+                wc = sim_fread (&conv_buff, 1, bc, uptr->fileref);
+            }
             while (wc < bc)
                  conv_buff[wc++] = 0;
             for (wp = wc = 0; wp < wps;) {
@@ -109,8 +157,12 @@ disk_read(UNIT *uptr, uint64 *buffer, int sector, int wps)
     case DLD9:
             bc = (wps / 2) * 9;
             da = sector * bc;
-            (void)sim_fseek(uptr->fileref, da, SEEK_SET);
-            wc = sim_fread (&conv_buff, 1, bc, uptr->fileref);
+            if (map != NULL) {
+                wc = (int)disk_map_read(map, conv_buff, (t_offset)da, bc);
+            } else {
+                (void)sim_fseek(uptr->fileref, da, SEEK_SET);
+                wc = sim_fread (&conv_buff, 1, bc, uptr->fileref);
+            }
             while (wc < bc)
                  conv_buff[wc++] = 0;
             for (wp = wc = 0; wp < wps;) {
@@ -141,9 +193,18 @@ disk_write(UNIT *uptr, uint64 *buffer, int sector, int wps)
     int      wp;
     uint64   temp;
     uint8    conv_buff[2048];
+    struct disk_map *map = (struct disk_map *)uptr->DISK_MAP;
     switch(GET_FMT(uptr->flags)) {
     case SIMH:
             da = sector * wps;
+            if (map != NULL) {
+                t_offset pos = (t_offset)da * sizeof(uint64);
+
+                if (pos + wps * sizeof(uint64) > (t_offset)map->size)
+                    return SCPE_IOERR;
+                sim_buf_copy_swapped (map->base + pos, buffer, sizeof(uint64), wps);
+                break;
+            }
             (void)sim_fseek(uptr->fileref, da * sizeof(uint64), SEEK_SET);
             wc = sim_fwrite (buffer, sizeof(uint64), wps, uptr->fileref);
             break;
@@ -164,6 +225,8 @@ disk_write(UNIT *uptr, uint64 *buffer, int sector, int wps)
                 conv_buff[wc++] = (uint8)(temp & 0xff);
             }
             da = sector * bc;
+            if (map != NULL)
+                return (disk_map_write(map, conv_buff, (t_offset)da, bc) == (size_t)bc) ? SCPE_OK : SCPE_IOERR;
             (void)sim_fseek(uptr->fileref, da, SEEK_SET);
             wc = sim_fwrite (&conv_buff, 1, bc, uptr->fileref);
             return SCPE_OK;
@@ -184,6 +247,8 @@ disk_write(UNIT *uptr, uint64 *buffer, int sector, int wps)
                 conv_buff[wc++] = (uint8)((temp >> 28) & 0xff);
             }
             da = sector * bc;
+            if (map != NULL)
+                return (disk_map_write(map, conv_buff, (t_offset)da, bc) == (size_t)bc) ? SCPE_OK : SCPE_IOERR;
             (void)sim_fseek(uptr->fileref, da, SEEK_SET);
             wc = sim_fwrite (&conv_buff, 1, bc, uptr->fileref);
             return SCPE_OK;
@@ -232,6 +297,11 @@ t_stat disk_attach (UNIT *uptr, CONST char *cptr)
 {
     t_stat r;
     char                 gbuf[30];
+    int                  share;
+    int                  ro;
+    struct disk_map      *map;
+    void                 *addr;
+    size_t               dsize;
 
     /* Reset to SIMH format on attach */
     uptr->flags &= ~UNIT_FMT;
@@ -244,9 +314,44 @@ t_stat disk_attach (UNIT *uptr, CONST char *cptr)
             return SCPE_ARG;
     }
 
+    /* Shared base image, open the container read only */
+    share = (sim_switches & SWMASK ('S')) != 0;
+    ro = ((sim_switches & SWMASK ('R')) != 0) || ((uptr->flags & UNIT_RO) != 0);
+    if (share) {
+        sim_switches |= SWMASK ('E');
+        uptr->flags |= UNIT_RO;
+    }
     r = attach_unit (uptr, cptr);
-    if (r != SCPE_OK)
+    if (r == SCPE_OK && share) {
+        map = (struct disk_map *)calloc (1, sizeof (*map));
+        if (map == NULL)
+            r = SCPE_MEM;
+        else {
+            /* Size the overlay to the drive, the container may be short */
+            if (GET_FMT(uptr->flags) == SIMH)
+                dsize = (size_t)uptr->capac * sizeof(uint64);
+            else
+                dsize = (size_t)(uptr->capac / 2) * 9;
+            r = sim_shmem_map_file (uptr->fileref, TRUE, dsize, &map->shmem, &addr, &map->size);
+        }
+        if (r != SCPE_OK && map != NULL) {
+            free (map);
+            r = sim_messagef (r, "%s: Can't map %s for sharing\n", sim_uname (uptr), cptr);
+        }
+        if (r != SCPE_OK)
+            detach_unit (uptr);
+    }
+    if (r != SCPE_OK) {
+        if (share && !ro)
+            uptr->flags &= ~UNIT_RO;
         return r;
+    }
+    if (share) {
+        map->base = (uint8 *)addr;
+        uptr->DISK_MAP = map;
+        if (!ro)
+            uptr->flags &= ~UNIT_RO;          /* Writes go to the private overlay */
+    }
     return SCPE_OK;
 }
 
@@ -254,6 +359,13 @@ t_stat disk_attach (UNIT *uptr, CONST char *cptr)
 
 t_stat disk_detach (UNIT *uptr)
 {
+    struct disk_map *map = (struct disk_map *)uptr->DISK_MAP;
+
+    if (map != NULL) {                        /* Discard the private overlay */
+        sim_shmem_close (map->shmem);
+        free (map);
+        uptr->DISK_MAP = NULL;
+    }
     return detach_unit (uptr);
 }
 
@@ -279,6 +391,9 @@ t_stat disk_attach_help(FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag, const ch
         fprintf (st, "  sim> ATTACH {switches} %s diskfile\n", dptr->name);
     fprintf (st, "\n%s attach command switches\n", dptr->name);
     fprintf (st, "    -R          Attach Read Only.\n");
+    fprintf (st, "    -S          Share the container as a read only base image with other\n");
+    fprintf (st, "                simulators.  Writes are kept private to this simulator and\n");
+    fprintf (st, "                are discarded on detach.\n");
     fprintf (st, "    -E          Must Exist (if not specified an attempt to create the indicated\n");
     fprintf (st, "                disk container will be attempted).\n");
     fprintf (st, "    -F          Open the indicated disk container in a specific format (default\n");
@@ -34,6 +34,9 @@
 #define DBD9            1                /* KLH10 Disb Big End Double */
 #define DLD9            2                /* KLH10 Disb Little End Double */
 
+#define DISK_MAP        up8              /* Shared mapping, units using
+                                            disk_attach must leave up8 free */
+
 /*
  *  SIMH format is number words per sector stored as a 64 bit word.
  *
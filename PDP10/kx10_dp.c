@@ -710,7 +710,15 @@ t_stat dp_svc (UNIT *uptr)
                     /* write block the block */
                     for (; uptr->DATAPTR < RP_NUMWD; uptr->DATAPTR++)
                         dp_buf[ctlr][uptr->DATAPTR] = 0;
-                    (void)disk_write(uptr, &dp_buf[ctlr][0], da, RP_NUMWD);
+                    if (disk_write(uptr, &dp_buf[ctlr][0], da, RP_NUMWD) != SCPE_OK) {
+                        uptr->STATUS |= DSK_PRTY;
+                        uptr->STATUS &= ~BUSY;
+                        uptr->UFLAGS |= DONE;
+                        uptr->DATAPTR = 0;
+                        CLR_BUF(uptr);
+                        df10_finish_op(df10, 0);
+                        return SCPE_OK;
+                    }
                     uptr->STATUS |= SRC_DONE;
                     sect = sect + 1;
                     if (sect >= dp_drv_tab[dtype].sect) {
@@ -796,7 +804,15 @@ t_stat dp_svc (UNIT *uptr)
                      /* write block the block */
                      for (; uptr->DATAPTR < RP_NUMWD; uptr->DATAPTR++)
                          dp_buf[ctlr][uptr->DATAPTR] = 0;
-                     (void)disk_write(uptr, &dp_buf[ctlr][0], da, RP_NUMWD);
+                     if (disk_write(uptr, &dp_buf[ctlr][0], da, RP_NUMWD) != SCPE_OK) {
+                         uptr->STATUS |= DSK_PRTY;
+                         uptr->STATUS &= ~BUSY;
+                         uptr->UFLAGS |= DONE;
+                         uptr->DATAPTR = 0;
+                         CLR_BUF(uptr);
+                         df10_finish_op(df10, 0);
+                         return SCPE_OK;
+                     }
                      uptr->STATUS |= SRC_DONE;
                      sect = sect + 1;
                      if (sect >= dp_drv_tab[dtype].sect) {
@@ -959,10 +975,10 @@ t_stat dp_attach (UNIT *uptr, CONST char *cptr)
     DIB *dib;
     int ctlr;
 
+    uptr->capac = dp_drv_tab[GET_DTYPE (uptr->flags)].size;
     r = disk_attach (uptr, cptr);
     if (r != SCPE_OK || (sim_switches & SIM_SW_REST) != 0)
         return r;
-    uptr->capac = dp_drv_tab[GET_DTYPE (uptr->flags)].size;
     dptr = find_dev_from_unit(uptr);
     if (dptr == 0)
         return SCPE_OK;
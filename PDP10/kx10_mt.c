@@ -197,6 +197,8 @@ MTAB                mt_mod[] = {
      &sim_tape_set_capac, &sim_tape_show_capac, NULL},
     {MTAB_XTD|MTAB_VUN|MTAB_VALR, 0, "DENSITY", "DENSITY",
      &sim_tape_set_dens, &sim_tape_show_dens, NULL},
+    {MTAB_XTD|MTAB_VUN|MTAB_NMO, 0, "STATISTICS", NULL,
+     NULL, &sim_tape_show_stats, NULL, "Display tape I/O statistics"},
 #if MPX_DEV
     {MTAB_XTD|MTAB_VDV|MTAB_VALR, 0, "MPX", "MPX",
      &mt_set_mpx, &mt_show_mpx, NULL},
@@ -1188,3 +1188,125 @@ int rh_write(struct rh_if *rhc) {
      return 1;
 }
 
+#if !KS
+/* Number of words of the current channel command that can be moved
+   directly to or from memory. The last word of the command, skipped
+   transfers and words near the end of memory are left for rh_read and
+   rh_write to handle */
+static uint32 rh_run(struct rh_if *rhc, uint32 max)
+{
+     uint32 run;
+
+     if (rhc->wcr == 0 || rhc->wcr > WMASK || rhc->cda == 0)
+         return 0;
+     run = (uint32)(((rhc->wcr ^ WMASK) + 1) & WMASK) - 1;
+     if (run > max)
+         run = max;
+#if KL
+     if (rhc->imode == 2) {
+         if (rhc->cda >= MEMSIZE)
+             return 0;
+         if (rhc->cop & 01) {
+             /* Reverse, stop before address zero */
+             if (run > rhc->cda)
+                 run = rhc->cda;
+         } else if (rhc->cda + run > MEMSIZE) {
+             run = MEMSIZE - rhc->cda;
+         }
+         return run;
+     }
+#endif
+     /* RH10 increments the address before each word */
+     if (rhc->cda + 1 >= MEMSIZE)
+         return 0;
+     if (rhc->cda + run >= MEMSIZE)
+         run = MEMSIZE - 1 - rhc->cda;
+     return run;
+}
+#endif
+
+/* Write a block of words, same as calling rh_write for each word.
+   Returns the status of the last rh_write, done is set to the
+   number of words taken from buf */
+int rh_write_block(struct rh_if *rhc, t_uint64 *buf, int count, int *done) {
+     int     n = 0;
+     int     sts = 1;
+#if !KS
+     uint32  run, i;
+#endif
+
+     while (n < count) {
+#if !KS
+         run = rh_run(rhc, count - n);
+         if (run != 0) {
+#if KL
+             if (rhc->imode == 2 && (rhc->cop & 01) != 0) {
+                 for (i = 0; i < run; i++)
+                     M[rhc->cda - i] = buf[n + i];
+                 rhc->cda = (uint32)((rhc->cda - run) & AMASK);
+             } else if (rhc->imode == 2) {
+                 memcpy(&M[rhc->cda], &buf[n], run * sizeof(t_uint64));
+                 rhc->cda = (uint32)((rhc->cda + run) & AMASK);
+             } else
+#endif
+             {
+                 memcpy(&M[rhc->cda + 1], &buf[n], run * sizeof(t_uint64));
+                 rhc->cda = (uint32)((rhc->cda + run) & AMASK);
+             }
+             rhc->wcr = (uint32)((rhc->wcr + run) & WMASK);
+             n += run;
+             rhc->buf = buf[n - 1];
+             continue;
+         }
+#endif
+         rhc->buf = buf[n++];
+         if ((sts = rh_write(rhc)) == 0)
+             break;
+     }
+     *done = n;
+     return sts;
+}
+
+/* Read a block of words, same as calling rh_read for each word.
+   Returns the status of the last rh_read, done is set to the
+   number of words stored in buf */
+int rh_read_block(struct rh_if *rhc, t_uint64 *buf, int count, int *done) {
+     int     n = 0;
+     int     sts = 1;
+#if !KS
+     uint32  run, i;
+#endif
+
+     while (n < count) {
+#if !KS
+         run = rh_run(rhc, count - n);
+         if (run != 0) {
+#if KL
+             if (rhc->imode == 2 && (rhc->cop & 01) != 0) {
+                 for (i = 0; i < run; i++)
+                     buf[n + i] = M[rhc->cda - i];
+                 rhc->cda = (uint32)((rhc->cda - run) & AMASK);
+             } else if (rhc->imode == 2) {
+                 memcpy(&buf[n], &M[rhc->cda], run * sizeof(t_uint64));
+                 rhc->cda = (uint32)((rhc->cda + run) & AMASK);
+             } else
+#endif
+             {
+                 memcpy(&buf[n], &M[rhc->cda + 1], run * sizeof(t_uint64));
+                 rhc->cda = (uint32)((rhc->cda + run) & AMASK);
+             }
+             rhc->wcr = (uint32)((rhc->wcr + run) & WMASK);
+             n += run;
+             rhc->buf = buf[n - 1];
+             continue;
+         }
+#endif
+         sts = rh_read(rhc);
+         buf[n++] = rhc->buf;
+         if (sts == 0)
+             break;
+     }
+     *done = n;
+     return sts;
+}
+
@@ -798,6 +798,7 @@ t_stat rp_svc (UNIT *uptr)
     struct rh_if *rhc;
     int           diff, da;
     int           sts;
+    int           wc, i;
 
     dptr = rp_devs[ctlr];
     rhc = &rp_rh[ctlr];
@@ -934,10 +935,17 @@ t_stat rp_svc (UNIT *uptr)
             }
         }
 
-        rhc->buf = rp_buf[ctlr][uptr->DATAPTR++];
-        sim_debug(DEBUG_DATA, dptr, "%s%o read word %d %012llo %09o %06o\n",
-                   dptr->name, unit, uptr->DATAPTR, rhc->buf, rhc->cda, rhc->wcr);
-        if (rh_write(rhc)) {
+        /* Transfer the rest of the sector at once, then wait as long
+           as it would have taken one word at a time */
+        sts = rh_write_block(rhc, &rp_buf[ctlr][uptr->DATAPTR],
+                             RP_NUMWD - uptr->DATAPTR, &wc);
+        if (dptr->dctrl & DEBUG_DATA) {
+            for (i = 0; i < wc; i++)
+                sim_debug(DEBUG_DATA, dptr, "%s%o read word %d %012llo\n",
+                       dptr->name, unit, uptr->DATAPTR + i + 1, rp_buf[ctlr][uptr->DATAPTR + i]);
+        }
+        uptr->DATAPTR += wc;
+        if (sts) {
             if (uptr->DATAPTR == RP_NUMWD) {
                 /* Increment to next sector. Set Last Sector */
                 uptr->DATAPTR = 0;
@@ -955,7 +963,7 @@ t_stat rp_svc (UNIT *uptr)
                 if (rh_blkend(rhc))
                     goto rd_end;
             }
-            sim_activate(uptr, 10);
+            sim_activate(uptr, 10 * wc);
         } else {
 rd_end:
             sim_debug(DEBUG_DETAIL, dptr, "%s%o read done\n", dptr->name, unit);
@@ -1000,10 +1008,14 @@ rd_end:
             uptr->DATAPTR = 0;
             uptr->hwmark = 0;
         }
-        sts = rh_read(rhc);
-        sim_debug(DEBUG_DATA, dptr, "%s%o write word %d %012llo %06o %06o\n",
-                      dptr->name, unit, uptr->DATAPTR, rhc->buf, rhc->cda, rhc->wcr);
-        rp_buf[ctlr][uptr->DATAPTR++] = rhc->buf;
+        sts = rh_read_block(rhc, &rp_buf[ctlr][uptr->DATAPTR],
+                            RP_NUMWD - uptr->DATAPTR, &wc);
+        if (dptr->dctrl & DEBUG_DATA) {
+            for (i = 0; i < wc; i++)
+                sim_debug(DEBUG_DATA, dptr, "%s%o write word %d %012llo\n",
+                          dptr->name, unit, uptr->DATAPTR + i, rp_buf[ctlr][uptr->DATAPTR + i]);
+        }
+        uptr->DATAPTR += wc;
         if (sts == 0) {
             while (uptr->DATAPTR < RP_NUMWD)
                 rp_buf[ctlr][uptr->DATAPTR++] = 0;
@@ -1012,7 +1024,13 @@ rd_end:
             sim_debug(DEBUG_DETAIL, dptr, "%s%o write (%d,%d,%d)\n", dptr->name,
                    unit, cyl, GET_SF(regs[RPDA]), GET_SC(regs[RPDA]));
             da = GET_DA(dtype);
-            (void)disk_write(uptr, &rp_buf[ctlr][0], da, RP_NUMWD);
+            if (disk_write(uptr, &rp_buf[ctlr][0], da, RP_NUMWD) != SCPE_OK) {
+                regs[RPER1] |= ER1_PAR;
+                regs[RPDS] |= DS_ATA;
+                uptr->DATAPTR = 0;
+                CLR_BUF(uptr);
+                goto wr_end;
+            }
             uptr->DATAPTR = 0;
             CLR_BUF(uptr);
             if (sts) {
@@ -1031,7 +1049,7 @@ rd_end:
                goto wr_end;
         }
         if (sts) {
-            sim_activate(uptr, 10);
+            sim_activate(uptr, 10 * wc);
         } else {
 wr_end:
             sim_debug(DEBUG_DETAIL, dptr, "RP%o write done\n", unit);
@@ -439,6 +439,7 @@ t_stat rs_svc (UNIT *uptr)
     struct rh_if *rhc;
     int           da;
     int           sts;
+    int           wc, i;
 
     /* Find dptr, and df10 */
     dptr = rs_devs[ctlr];
@@ -501,10 +502,17 @@ t_stat rs_svc (UNIT *uptr)
             uptr->DATAPTR = 0;
         }
 
-        rhc->buf = rs_buf[ctlr][uptr->DATAPTR++];
-        sim_debug(DEBUG_DATA, dptr, "%s%o read word %d %012llo %09o %06o\n",
-                dptr->name, unit, uptr->DATAPTR, rhc->buf, rhc->cda, rhc->wcr);
-        if (rh_write(rhc)) {
+        /* Transfer the rest of the sector at once, then wait as long
+           as it would have taken one word at a time */
+        sts = rh_write_block(rhc, &rs_buf[ctlr][uptr->DATAPTR],
+                             RS_NUMWD - uptr->DATAPTR, &wc);
+        if (dptr->dctrl & DEBUG_DATA) {
+            for (i = 0; i < wc; i++)
+                sim_debug(DEBUG_DATA, dptr, "%s%o read word %d %012llo\n",
+                    dptr->name, unit, uptr->DATAPTR + i + 1, rs_buf[ctlr][uptr->DATAPTR + i]);
+        }
+        uptr->DATAPTR += wc;
+        if (sts) {
             if (uptr->DATAPTR == RS_NUMWD) {
                 /* Increment to next sector. Set Last Sector */
                 uptr->DATAPTR = 0;
@@ -519,7 +527,7 @@ t_stat rs_svc (UNIT *uptr)
                 if (rh_blkend(rhc))
                    goto rd_end;
             }
-            sim_activate(uptr, 10);
+            sim_activate(uptr, 10 * wc);
         } else {
 rd_end:
             sim_debug(DEBUG_DETAIL, dptr, "%s%o read done\n", dptr->name, unit);
@@ -545,10 +553,14 @@ rd_end:
             uptr->DATAPTR = 0;
             uptr->hwmark = 0;
         }
-        sts = rh_read(rhc);
-        rs_buf[ctlr][uptr->DATAPTR++] = rhc->buf;
-        sim_debug(DEBUG_DATA, dptr, "%s%o write word %d %012llo %09o %06o\n",
-                 dptr->name, unit, uptr->DATAPTR, rhc->buf, rhc->cda, rhc->wcr);
+        sts = rh_read_block(rhc, &rs_buf[ctlr][uptr->DATAPTR],
+                            RS_NUMWD - uptr->DATAPTR, &wc);
+        if (dptr->dctrl & DEBUG_DATA) {
+            for (i = 0; i < wc; i++)
+                sim_debug(DEBUG_DATA, dptr, "%s%o write word %d %012llo\n",
+                     dptr->name, unit, uptr->DATAPTR + i + 1, rs_buf[ctlr][uptr->DATAPTR + i]);
+        }
+        uptr->DATAPTR += wc;
         if (sts == 0) {
             while (uptr->DATAPTR < RS_NUMWD)
                 rs_buf[ctlr][uptr->DATAPTR++] = 0;
@@ -575,7 +587,7 @@ rd_end:
                   goto wr_end;
         }
         if (sts) {
-            sim_activate(uptr, 10);
+            sim_activate(uptr, 10 * wc);
         } else {
 wr_end:
             sim_debug(DEBUG_DETAIL, dptr, "%s%o write done\n", dptr->name, unit);
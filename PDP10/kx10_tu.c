@@ -32,6 +32,7 @@
 
 #define NUM_UNITS_TU    8
 #define TU_NUMFR        (64*1024)
+#define TU_BLKWD        128             /* Words moved per block transfer */
 
 #define BUF_EMPTY(u)  (u->hwmark == 0xFFFFFFFF)
 #define CLR_BUF(u)     u->hwmark = 0xFFFFFFFF
@@ -225,6 +226,8 @@ MTAB                tu_mod[] = {
      &sim_tape_set_capac, &sim_tape_show_capac, NULL},
     {MTAB_XTD|MTAB_VUN|MTAB_VALR, 0, "DENSITY", "DENSITY",
      &sim_tape_set_dens, &sim_tape_show_dens, NULL},
+    {MTAB_XTD|MTAB_VUN|MTAB_NMO, 0, "STATISTICS", NULL,
+     NULL, &sim_tape_show_stats, NULL, "Display tape I/O statistics"},
 #if KS
     {MTAB_XTD|MTAB_VDV|MTAB_VALR, 0, "addr", "addr",  &uba_set_addr, uba_show_addr,
               NULL, "Sets address of RH11" },
@@ -557,6 +560,8 @@ t_stat tu_srv(UNIT * uptr)
     uint8         ch;
     int           cc;
     int           cc_max;
+    t_uint64      wbuf[TU_BLKWD];
+    int           nw, wc, sts, i, j;
 
     /* Find dptr, and df10 */
     dptr = tu_devs[ctlr];
@@ -671,6 +676,48 @@ t_stat tu_srv(UNIT * uptr)
              }
              return SCPE_OK;
          }
+         /* Pack whole words and hand them to the channel as a block,
+            then wait as long as the frames would have taken */
+         if (GET_FNC(uptr->CMD) == FNC_READ && uptr->CPOS == 0) {
+             nw = (uptr->hwmark - uptr->DATAPTR) / cc_max;
+             if (nw > (0x10000 - regs[TUDC]) / cc_max)
+                 nw = (0x10000 - regs[TUDC]) / cc_max;
+             if (nw > TU_BLKWD)
+                 nw = TU_BLKWD;
+             if (nw > 1) {
+                 for (i = 0; i < nw; i++) {
+                     wbuf[i] = 0;
+                     for (j = 0; j < cc_max; j++) {
+                         cc = (8 * (3 - j)) + 4;
+                         ch = tu_buf[ctlr][uptr->DATAPTR + (i * cc_max) + j];
+                         if (cc < 0)
+                             wbuf[i] |= (uint64)(ch & 0x0f);
+                         else
+                             wbuf[i] |= (uint64)(ch & 0xff) << cc;
+                     }
+                 }
+                 sts = rh_write_block(rhc, wbuf, nw, &wc);
+                 if (dptr->dctrl & DEBUG_DATA) {
+                     for (i = 0; i < wc; i++)
+                         sim_debug(DEBUG_DATA, dptr, "%s%o read %012llo %d\n",
+                                   dptr->name, unit, wbuf[i], uptr->DATAPTR + ((i + 1) * cc_max));
+                 }
+                 uptr->DATAPTR += wc * cc_max;
+                 regs[TUDC] += wc * cc_max;
+                 if (regs[TUDC] == 0)
+                    regs[TUTC] &= ~TC_FCS;
+                 if (sts == 0) {
+                     tu_error(uptr, MTSE_OK);
+                     if ((uint32)uptr->DATAPTR == uptr->hwmark)
+                         (void)rh_blkend(rhc);
+                     rh_finish_op(rhc, 0);
+                     return SCPE_OK;
+                 }
+                 rhc->buf = 0;
+                 sim_activate(uptr, 50 * wc * cc_max);
+                 return SCPE_OK;
+             }
+         }
          if ((uint32)uptr->DATAPTR < uptr->hwmark) {
              regs[TUDC]++;
              if (regs[TUDC] == 0)
@@ -733,6 +780,46 @@ t_stat tu_srv(UNIT * uptr)
              uptr->DATAPTR = 0;
              rhc->buf = 0;
          }
+         /* Take whole words from the channel as a block while the frame
+            count can not run out, then wait as long as the frames would
+            have taken */
+         if (regs[TUDC] != 0 && uptr->CPOS == 0) {
+             nw = (0xffff - regs[TUDC]) / cc_max;
+             if (nw > TU_BLKWD)
+                 nw = TU_BLKWD;
+             if (nw > 1) {
+                 sts = rh_read_block(rhc, wbuf, nw, &wc);
+                 for (i = 0; i < wc; i++) {
+                     sim_debug(DEBUG_DATA, dptr, "%s%o write %012llo\n",
+                               dptr->name, unit, wbuf[i]);
+                     for (j = 0; j < cc_max; j++) {
+                         cc = (8 * (3 - j)) + 4;
+                         if (cc < 0)
+                              ch = wbuf[i] & 0x0f;
+                         else
+                              ch = (wbuf[i] >> cc) & 0xff;
+                         tu_buf[ctlr][uptr->DATAPTR++] = ch;
+                     }
+                 }
+                 uptr->hwmark = uptr->DATAPTR;
+                 regs[TUDC] += wc * cc_max;
+                 if (sts == 0) {
+                     /* Write out the block */
+                     reclen = uptr->hwmark;
+                     r = sim_tape_wrrecf(uptr, &tu_buf[ctlr][0], reclen);
+                     sim_debug(DEBUG_DETAIL, dptr, "%s%o Write %d %d\n",
+                                  dptr->name, unit, reclen, uptr->CPOS);
+                     uptr->DATAPTR = 0;
+                     uptr->hwmark = 0;
+                     (void)rh_blkend(rhc);
+                     tu_error(uptr, r); /* Record errors */
+                     rh_finish_op(rhc,0 );
+                     return SCPE_OK;
+                 }
+                 sim_activate(uptr, 50 * wc * cc_max);
+                 return SCPE_OK;
+             }
+         }
          if (regs[TUDC] != 0 && uptr->CPOS == 0 && rh_read(rhc) == 0)
              uptr->CPOS |= 010;
 
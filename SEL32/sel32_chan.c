@@ -3060,3 +3060,120 @@ t_stat show_dev_addr(FILE *st, UNIT *uptr, int32 v, CONST void *desc) {
     return SCPE_OK;                             /* we done */
 }
 
+/* get the track cache for a disk unit, allocating it if needed */
+/* tsize is the number of bytes in a track of the unit's disk type */
+struct _trk_cache *trk_cache(UNIT *uptr, uint32 tsize)
+{
+    struct  _trk_cache *tc = (struct _trk_cache *)uptr->up7;
+
+    if (tc == NULL) {
+        tc = (struct _trk_cache *)calloc(1, sizeof(struct _trk_cache));
+        if (tc == NULL)
+            return NULL;                        /* run without a cache */
+        uptr->up7 = (void *)tc;
+    }
+    if (tc->size != tsize) {                    /* disk type changed */
+        free(tc->data);
+        tc->data = (uint8 *)malloc(tsize);
+        tc->size = (tc->data == NULL) ? 0 : tsize;
+        tc->len = 0;
+    }
+    return tc;
+}
+
+/* forget everything in the track cache */
+void trk_cache_inval(UNIT *uptr)
+{
+    struct  _trk_cache *tc = (struct _trk_cache *)uptr->up7;
+    int     cn;
+
+    if (tc == NULL)
+        return;
+    tc->len = 0;
+    for (cn=0; cn<TRK_CACHE; cn++) {
+        tc->lab.tkl[cn].track = 0;
+        tc->lab.tkl[cn].age = 0;
+    }
+}
+
+/* release the track cache when the disk is detached */
+void trk_cache_free(UNIT *uptr)
+{
+    struct  _trk_cache *tc = (struct _trk_cache *)uptr->up7;
+
+    if (tc == NULL)
+        return;
+    free(tc->data);
+    free(tc);
+    uptr->up7 = NULL;
+}
+
+/* read a sector at file offset tstart through the track cache */
+/* return the number of bytes read, like sim_fread */
+int trk_cache_read(UNIT *uptr, uint32 tsize, uint32 tstart, uint8 *buf, int ssize)
+{
+    struct  _trk_cache *tc = trk_cache(uptr, tsize);
+    uint32  toff;
+    int     len;
+
+    if ((tc == NULL) || (tc->size == 0) || ((uint32)ssize > tc->size)) {
+        /* no cache, read the sector by itself */
+        if ((sim_fseek(uptr->fileref, tstart, SEEK_SET)) != 0)
+            return 0;
+        return (int)sim_fread(buf, 1, ssize, uptr->fileref);
+    }
+    toff = (tstart / tc->size) * tc->size;      /* start of track in file */
+    if ((tc->len == 0) || (tc->offset != toff)) {
+        /* read the whole track in one host read */
+        tc->len = 0;
+        tc->misses++;
+        if ((sim_fseek(uptr->fileref, toff, SEEK_SET)) != 0)
+            return 0;
+        len = (int)sim_fread(tc->data, 1, tc->size, uptr->fileref);
+        if (len <= 0)
+            return 0;
+        tc->offset = toff;
+        tc->len = len;
+    } else
+        tc->hits++;
+    if ((tstart - toff) >= tc->len)
+        return 0;                               /* past end of file */
+    len = tc->len - (tstart - toff);
+    if (len > ssize)
+        len = ssize;
+    memcpy(buf, tc->data + (tstart - toff), len);
+    return len;
+}
+
+/* keep the cached track in step with ssize bytes written at tstart */
+void trk_cache_write(UNIT *uptr, uint32 tstart, uint8 *buf, int ssize)
+{
+    struct  _trk_cache *tc = (struct _trk_cache *)uptr->up7;
+
+    if ((tc == NULL) || (tc->len == 0))
+        return;
+    if ((tstart >= tc->offset) && ((tstart + ssize) <= (tc->offset + tc->len)))
+        memcpy(tc->data + (tstart - tc->offset), buf, ssize);
+    else
+    if ((tstart < (tc->offset + tc->size)) && ((tstart + ssize) > tc->offset))
+        tc->len = 0;                            /* partly cached, drop it */
+}
+
+/* show track cache statistics for a disk unit */
+t_stat trk_cache_show(FILE *st, UNIT *uptr, int32 v, CONST void *desc)
+{
+    struct  _trk_cache *tc;
+
+    if (uptr == NULL)
+        return SCPE_IERR;
+    tc = (struct _trk_cache *)uptr->up7;
+    if (tc == NULL) {
+        fputs("CACHE empty", st);
+        return SCPE_OK;
+    }
+    fprintf(st, "CACHE hits=%u misses=%u", tc->hits, tc->misses);
+    if (tc->lhits || tc->lmisses)
+        fprintf(st, " label hits=%u misses=%u", tc->lhits, tc->lmisses);
+    return SCPE_OK;
+}
+
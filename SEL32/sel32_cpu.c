@@ -112,6 +112,29 @@ LOCAL   uint32  pfault;                     /* page # of fault from read/write *
 /* bits 8-18 has map reg contents for this page (Map << 13) */
 /* bit 19-31 is zero for page offset of zero */
 
+/* Translation cache for Mem_read/Mem_write on the 32/27 and up in mapped */
+/* mode.  One entry per 2KW logical page holds the real page address and */
+/* whether a read, or a write to each 1/4 page, has already passed all of */
+/* the RealAddr and protection checks.  Entries are valid only while their */
+/* gen matches TCGEN, so tc_flush() drops them all at once.  It is called */
+/* when the maps are loaded, when the MPL pointer in SPAD is changed, and */
+/* when a CPU write lands in a page holding the MPL, a MSDL entry or a map */
+/* entry used by a cached translation (TCWATCH).  The PSD mode bits are */
+/* part of the tag.  Memory written by channel DMA or by the IPU is not */
+/* watched, so the cache is not filled when an IPU is configured. */
+#define TC_RD       0x10                    /* read access checked */
+#define TC_WR       0x01                    /* write access checked, 1 bit per 1/4 page */
+#define TC_NOMAP    0xffffffff              /* no memory map entry to watch */
+#define TC_MODES    (MAPMODE|PRIVBIT|BASEBIT|EXTDBIT)   /* modes used by RealAddr */
+LOCAL   struct tcache {
+    uint32  gen;                            /* TCGEN when entry was filled */
+    uint32  modes;                          /* MODES & TC_MODES when entry was filled */
+    uint32  raddr;                          /* real address of the page */
+    uint32  flags;                          /* TC_RD and TC_WR bits */
+} TCACHE[2048];
+LOCAL   uint32  TCWATCH[2048];              /* TCGEN if real 8KB page has map data in use */
+LOCAL   uint32  TCGEN = 1;                  /* current translation cache generation */
+
 LOCAL   uint8           wait4int = 0;       /* waiting for interrupt if set */
 #ifndef CPUONLY
 LOCAL   uint8           wait4sipu = 0;      /* waiting for sipu in IPU if set */
@@ -142,6 +165,7 @@ LOCAL  t_stat load_maps(uint32 thepsd[2], uint32 lmap);
 LOCAL  t_stat read_instruction(uint32 thepsd[2], uint32 *instr);
 LOCAL  t_stat Mem_read(uint32 addr, uint32 *data);
 LOCAL  t_stat Mem_write(uint32 addr, uint32 *data);
+LOCAL  void tc_flush(void);
 
 /* external definitions */
 extern t_stat checkxio(uint16 addr, uint32 *status);    /* XIO check in chan.c */
@@ -561,6 +585,46 @@ LOCAL void unlock_mutex()
         pthread_mutex_unlock((pthread_mutex_t *)&(IPC->mutex));
     }
 }
+/* take the async trap posted by the peer, zero if none */
+LOCAL int take_atrap()
+{
+    int32   trap;
+
+    do {
+        trap = IPC->atrap[MyIndex];                 /* get trap number */
+    } while (trap && !sim_shmem_atomic_cas(&IPC->atrap[MyIndex], trap, 0));
+    return trap;
+}
+
+/* post an async trap to the peer, zero if one is still pending */
+/* the mutex is only taken when the peer is asleep waiting for it */
+LOCAL int post_atrap(int32 trap)
+{
+    if (!sim_shmem_atomic_cas(&IPC->atrap[PeerIndex], 0, trap))
+        return 0;                                   /* previous atrap not taken yet */
+    if (sim_shmem_atomic_add(&IPC->sleeping[PeerIndex], 0)) {
+        lock_mutex();                               /* lock mutex */
+        pthread_cond_broadcast(&IPC->cond);         /* wake the waiter */
+        unlock_mutex();                             /* unlock mutex */
+        IPC->wakeups[MyIndex]++;                    /* count the wakeup */
+    }
+    return 1;
+}
+
+/* sleep until the peer posts an async trap */
+LOCAL void wait_atrap()
+{
+    uint32  start = sim_os_msec();
+
+    lock_mutex();                                   /* lock mutex */
+    sim_shmem_atomic_add(&IPC->sleeping[MyIndex], 1);
+    while (IPC->atrap[MyIndex] == 0)                /* sleep on the condition */
+        pthread_cond_wait(&IPC->cond, &IPC->mutex); /* wait for wakeup */
+    sim_shmem_atomic_add(&IPC->sleeping[MyIndex], -1);
+    unlock_mutex();                                 /* unlock mutex and continue */
+    IPC->sleeps[MyIndex]++;                         /* count the wait */
+    IPC->sleepms[MyIndex] += sim_os_msec() - start;
+}
 #endif
 #endif /* CPUONLY */
 
@@ -606,6 +670,7 @@ LOCAL t_stat load_maps(uint32 thepsd[2], uint32 lmap)
     uint32 cpix, bpix, i, j, map, osmsdl, osmidl;
     uint32 MAXMAP = MAX2048;                        /* default to 2048 maps */
 
+    tc_flush();                                     /* maps are changing, drop cached translations */
     sim_debug(DEBUG_CMD, my_dev,
         "Load Maps Entry PSD %08x %08x STATUS %08x lmap %1x CPU Mode %2x\n",
         thepsd[0], thepsd[1], CPUSTATUS, lmap, CPU_MODEL);
@@ -1589,6 +1654,50 @@ LOCAL t_stat read_instruction(uint32 thepsd[2], uint32 *instr)
     return status;                                  /* return ALLOK or ERROR status */
 }
 
+/* invalidate all translation cache entries */
+LOCAL void tc_flush(void)
+{
+    if (++TCGEN == 0) {                             /* generation wrapped */
+        memset(TCACHE, 0, sizeof(TCACHE));          /* clear every entry */
+        memset(TCWATCH, 0, sizeof(TCWATCH));        /* and every watched page */
+        TCGEN = 1;
+    }
+}
+
+/* record a translation that has passed all checks in Mem_read/Mem_write */
+/* flag is TC_RD or the TC_WR bit for the 1/4 page written */
+/* maddr is the real address of the memory map entry used, or TC_NOMAP */
+LOCAL void tc_fill(uint32 addr, uint32 realaddr, uint32 flag, uint32 maddr)
+{
+    uint32 word, mpl, modes = MODES & TC_MODES;
+    struct tcache *tc;
+
+    if (((MODES & MAPMODE) == 0) || (CPU_MODEL < MODEL_27))
+        return;                                     /* only mapped 2KW page machines */
+    if (CCW & HASIPU)
+        return;                                     /* IPU may change the maps */
+    if (sim_deb && (my_dev->dctrl & (DEBUG_DETAIL|DEBUG_EXP|DEBUG_TRAP)))
+        return;                                     /* keep all the debug output */
+    mpl = SPAD[0xf3] & MASK24;                      /* get mpl from spad address */
+    TCWATCH[((mpl+4) & MASK24) >> 13] = TCGEN;      /* O/S msdl pointer */
+    TCWATCH[((mpl+CPIX+4) & MASK24) >> 13] = TCGEN; /* user msdl pointer */
+    if (maddr != TC_NOMAP)
+        TCWATCH[(maddr & MASK24) >> 13] = TCGEN;    /* memory map entry */
+    if (modes & (BASEBIT|EXTDBIT))
+        word = addr & 0xffffff;                     /* get 24 bit address */
+    else
+        word = addr & 0x7ffff;                      /* get 19 bit address */
+    tc = &TCACHE[word >> 13];
+    realaddr &= 0xffe000;                           /* real page address */
+    if ((tc->gen != TCGEN) || (tc->modes != modes) || (tc->raddr != realaddr)) {
+        tc->gen = TCGEN;                            /* new entry */
+        tc->modes = modes;
+        tc->raddr = realaddr;
+        tc->flags = 0;
+    }
+    tc->flags |= flag;                              /* access now checked */
+}
+
 /*
  * Read a full word from memory
  * Return error type if failure, ALLOK if
@@ -1597,6 +1706,14 @@ LOCAL t_stat read_instruction(uint32 thepsd[2], uint32 *instr)
 LOCAL t_stat Mem_read(uint32 addr, uint32 *data)
 {
     uint32 status, realaddr=0, prot, page, map, mix, nix, msdl, mpl, nmap;
+    uint32 word = addr & ((MODES & (BASEBIT|EXTDBIT)) ? 0xffffff : 0x7ffff);
+    struct tcache *tc = &TCACHE[word >> 13];
+
+    /* use the cached translation if this page has been read since the last flush */
+    if ((tc->gen == TCGEN) && (tc->modes == (MODES & TC_MODES)) && (tc->flags & TC_RD)) {
+        *data = RMW(tc->raddr | (word & 0x1fff));   /* get physical address contents */
+        return ALLOK;
+    }
 
     status = RealAddr(addr, &realaddr, &prot, MEM_RD);  /* convert address to real physical address */
 
@@ -1652,6 +1769,7 @@ LOCAL t_stat Mem_read(uint32 addr, uint32 *data)
         sim_debug(DEBUG_DETAIL, my_dev,
             "Mem_read addr %06x realaddr %06x data %08x prot %02x\n",
             addr, realaddr, *data, prot);
+        tc_fill(addr, realaddr, TC_RD, TC_NOMAP);   /* read access is now checked */
     } else {
         /* RealAddr returned an error */
         sim_debug(DEBUG_EXP, my_dev,
@@ -1683,6 +1801,19 @@ LOCAL t_stat Mem_read(uint32 addr, uint32 *data)
 LOCAL t_stat Mem_write(uint32 addr, uint32 *data)
 {
     uint32 status, realaddr=0, prot=0, raddr, page, nmap, msdl, mpl, map, nix, mix;
+    uint32 maddr = TC_NOMAP;
+    uint32 word = addr & ((MODES & (BASEBIT|EXTDBIT)) ? 0xffffff : 0x7ffff);
+    struct tcache *tc = &TCACHE[word >> 13];
+
+    /* use the cached translation if this 1/4 page has been written since the last flush */
+    if ((tc->gen == TCGEN) && (tc->modes == (MODES & TC_MODES)) &&
+        (tc->flags & (TC_WR << ((word >> 11) & 3)))) {
+        realaddr = tc->raddr | (word & 0x1fff);     /* real address */
+        if (TCWATCH[realaddr >> 13] == TCGEN)       /* writing map data in use */
+            tc_flush();                             /* drop cached translations */
+        WMW(realaddr, *data);                       /* put physical address contents */
+        return ALLOK;
+    }
 
     status = RealAddr(addr, &realaddr, &prot, MEM_WR);  /* convert address to real physical address */
 
@@ -1725,6 +1856,7 @@ LOCAL t_stat Mem_write(uint32 addr, uint32 *data)
                     mix = nix-BPIX;                 /* get map index in memory */
                     msdl = RMW(mpl+CPIX+4);         /* get mpl entry for given cpix */
                 }
+                maddr = msdl+(mix<<1);              /* real address of memory map entry */
                 nmap = RMH(msdl+(mix<<1));          /* map content from memory */      
                 if ((nmap & 0x1000) == 0) {
                     nmap |= 0x1800;                 /* set the modify/accessed bit in the map cache entry */
@@ -1759,7 +1891,10 @@ LOCAL t_stat Mem_write(uint32 addr, uint32 *data)
                 return MPVIOL;                      /* return memory protection violation */
             }
         }
+        if (TCWATCH[(realaddr & MASK24) >> 13] == TCGEN)    /* writing map data in use */
+            tc_flush();                             /* drop cached translations */
         WMW(realaddr, *data);                       /* valid address, put physical address contents */
+        tc_fill(addr, realaddr, TC_WR << ((realaddr >> 11) & 3), maddr);  /* write access is now checked */
     } else {
         /* RealAddr returned an error */
         sim_debug(DEBUG_TRAP, my_dev,
@@ -1848,6 +1983,7 @@ t_stat sim_instr(void) {
     int32               int32c;                     /* temp int */
 
     reason = SCPE_OK;
+    tc_flush();                                     /* SCP may have changed memory or maps */
 
     /* loop here until time out or error found */
 wait_loop:
@@ -2150,10 +2286,7 @@ loadend:
                 /* we have a trap available, lock and get it */
 cond_go:
                 if (IPC && IPC->atrap[MyIndex]) {
-                    lock_mutex();                   /* lock mutex */
-                    TRAPME = IPC->atrap[MyIndex];   /* get trap number */
-                    IPC->atrap[MyIndex] = 0;        /* clear trap value location */
-                    unlock_mutex();                 /* unlock mutex */
+                    TRAPME = take_atrap();          /* get and clear trap number */
                     IPC->received[MyIndex]++;       /* count it received */
                     wait4sipu = 0;                  /* wait is over for sipu */
                     sim_debug(DEBUG_TRAP, my_dev, "%s: (%d) Async TRAP %02x SPAD[0xf0] %02x rec'd %08x\n",
@@ -2167,10 +2300,7 @@ cond_go:
                 }
                 /* unblocked and locked and no async trap */
                 if (wait4sipu) {                    /* are we to wait */
-                    lock_mutex();                   /* lock mutex */
-                    while (IPC->atrap[MyIndex]==0)  /* sleep on the condition */
-                        pthread_cond_wait(&IPC->cond, &IPC->mutex); /* wait for wakeup */
-                    unlock_mutex();                 /* unlock mutex and continue */
+                    wait_atrap();                   /* sleep until peer posts a trap */
                     goto cond_go;                   /* go process */
                 }
                 /* not waiting for sipu, so continue processing */
@@ -3068,11 +3198,7 @@ exec2:
                         //GR  Give it a millisec to unblock the atrap
                         sim_os_ms_sleep(10);        /* wait 10 ms */
                     }
-                    if (IPC->atrap[PeerIndex] == 0) {
-                        lock_mutex();               /* lock mutex */
-                        IPC->atrap[PeerIndex] = SIGNALIPU_TRAP;
-                        pthread_cond_signal(&IPC->cond);    /* wake any waiters */
-                        unlock_mutex();             /* unlock mutex */
+                    if (post_atrap(SIGNALIPU_TRAP)) {
                         IPC->sent[MyIndex]++;
                         sim_debug(DEBUG_TRAP, my_dev,
                             "%s: Async SIPU sent IPUSTATUS %08x CCW %08x SPAD[0xf0] %02x sent %08x\n",
@@ -4080,6 +4206,8 @@ tbr:                                                /* handle basemode TBR too *
                 t = (GPR[reg] >> 16) & 0xff;        /* get SPAD address from Rd (6-8) */
                 temp2 = SPAD[t];                    /* get old SPAD data */
                 SPAD[t] = GPR[sreg];                /* store Rs into SPAD */
+                if (t == 0xf3)                      /* new MPL address */
+                    tc_flush();                     /* drop cached translations */
                 sim_debug(DEBUG_TRAP, my_dev,
                     "TRSC SPAD[%04x] B4 %08x New %08x\n", t, temp2, GPR[sreg]);
                 break;
@@ -7864,6 +7992,7 @@ t_stat cpu_reset(DEVICE *dptr)
             ival = 0xfffffff;                       /* init value for 32/7x int and dev entries */
         for (i = 0; i < 1024; i++)
             MAPC[i] = 0;                            /* clear 2048 halfword map cache */
+        tc_flush();                                 /* drop cached translations */
         for (i = 0; i < 224; i++)
             SPAD[i] = ival;                         /* init 128 devices and 96 ints in the spad */
         for (i = 224; i < 256; i++)                 /* clear the last 32 extries */
@@ -8065,10 +8194,30 @@ t_stat cpu_clr_ipu(UNIT *uptr, int32 sval, CONST char *cptr, void *desc)
 
 t_stat cpu_show_ipu(FILE *st, UNIT *uptr, int32 val, CONST void *desc)
 {
+    int     i;
+
     if (IPU_MODEL)
-        sim_printf("IPU enabled\n");
+        fprintf(st, "IPU enabled\n");
     else
-        sim_printf("IPU disabled\n");
+        fprintf(st, "IPU disabled\n");
+    if (IPC == 0)
+        return SCPE_OK;                             /* no IPU started yet */
+    for (i = 0; i < 2; i++) {
+        fprintf(st, "%s: SIPU sent %d received %d blocked %d dropped %d\n",
+            i ? "IPU" : "CPU", IPC->sent[i], IPC->received[i],
+            IPC->blocked[i], IPC->dropped[i]);
+#ifdef USE_POSIX_SEM
+        fprintf(st, "     semaphore passed %d waited %d\n",
+            IPC->pass[i], IPC->wait[i]);
+#else
+        fprintf(st, "     mutex passed %d contended %d\n",
+            IPC->pass[i], IPC->wait[i]);
+        fprintf(st, "     waits for SIPU %d, %u ms, avg %u ms, wakeups sent %d\n",
+            IPC->sleeps[i], IPC->sleepms[i],
+            IPC->sleeps[i] ? IPC->sleepms[i] / IPC->sleeps[i] : 0,
+            IPC->wakeups[i]);
+#endif
+    }
     return SCPE_OK;                                 /* we done */
 }
 #endif
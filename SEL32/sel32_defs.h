@@ -112,6 +112,10 @@ struct ipcom {
     pthread_cond_t  cond;               /* conditional wait condition */
     int     pass[2];                    /* count passing */
     int     wait[2];                    /* count waiting */
+    int     sleeping[2];                /* set while waiting for atrap */
+    int     sleeps[2];                  /* count waits for atrap */
+    int     wakeups[2];                 /* count wakeups sent to peer */
+    uint32  sleepms[2];                 /* total ms waited for atrap */
 };
 #endif
 #endif
@@ -591,6 +595,47 @@ extern  DEVICE *get_dev(UNIT *uptr);
 extern  t_stat  set_inch(UNIT *uptr, uint32 inch_addr, uint32 num_inch);    /* set inch addr */
 extern  CHANP  *find_chanp_ptr(uint16 chsa);    /* find chanp pointer */
 
+/* Disk track cache used by the UDP/DPII, HSDP and SCFI disk controllers. */
+/* It is allocated on first use and kept in the unit's up7 pointer.  Sector */
+/* reads are served from one cached data track, so reading consecutive */
+/* sectors costs one host read per track.  Sector writes still go straight */
+/* to the file and update the cached copy.  UDP and HSDP also keep their */
+/* track labels here; SCFI disks have none. */
+#define TRK_CACHE 10                    /* track labels cached per unit */
+
+/* track label queue */
+struct _trk_data
+{
+    int32   age;
+    uint32  track;
+    uint8   label[30];
+};
+
+struct _trk_label
+{
+    struct  _trk_data   tkl[TRK_CACHE];
+};
+
+struct _trk_cache
+{
+    struct  _trk_label  lab;            /* track label cache */
+    uint32  offset;                     /* file offset of cached track */
+    uint32  len;                        /* bytes valid in data, 0 if none */
+    uint32  size;                       /* bytes allocated for data */
+    uint32  hits;                       /* sectors read from cache */
+    uint32  misses;                     /* tracks read from file */
+    uint32  lhits;                      /* track labels found in cache */
+    uint32  lmisses;                    /* track labels read from file */
+    uint8   *data;                      /* track data */
+};
+
+extern  struct _trk_cache *trk_cache(UNIT *uptr, uint32 tsize);
+extern  void    trk_cache_inval(UNIT *uptr);
+extern  void    trk_cache_free(UNIT *uptr);
+extern  int     trk_cache_read(UNIT *uptr, uint32 tsize, uint32 tstart, uint8 *buf, int ssize);
+extern  void    trk_cache_write(UNIT *uptr, uint32 tstart, uint8 *buf, int ssize);
+extern  t_stat  trk_cache_show(FILE *st, UNIT *uptr, int32 v, CONST void *desc);
+
 #ifndef CPUONLY
 #ifndef USE_IPU_THREAD
 extern  struct ipcom *IPC;
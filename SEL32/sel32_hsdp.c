@@ -548,27 +548,13 @@ CHANP   dpa_chp[NUM_UNITS_HSDP] = {0};
 /* IOCL queue */
 IOCLQ   dpa_ioclq[NUM_UNITS_HSDP] = {0};
 
-#define TRK_CACHE 10
-/* track label queue */
-struct _trk_data
-{
-    int32   age;
-    uint32  track;
-    uint8   label[30];
-};
-
-struct _trk_label
-{
-    struct  _trk_data   tkl[TRK_CACHE];
-};
-
-static struct _trk_label tkl_label[NUM_UNITS_HSDP] = {0};
-
 MTAB            hsdp_mod[] = {
     {MTAB_XTD | MTAB_VUN | MTAB_VALR, 0, "TYPE", "TYPE",
     &hsdp_set_type, &hsdp_get_type, NULL, "Type of disk"},
     {MTAB_XTD | MTAB_VUN | MTAB_VALR, 0, "DEV", "DEV", &set_dev_addr,
         &show_dev_addr, NULL, "Device channel address"},
+    {MTAB_XTD | MTAB_VUN, 0, "CACHE", NULL, NULL,
+        &trk_cache_show, NULL, "Track cache statistics"},
     {0},
 };
 
@@ -718,6 +704,7 @@ uint32 hsdpsec2star(uint32 daddr, int type)
     return (CHS2STAR(cyl,hds,sec));             /* return STAR */
 }
 
+
 /* read alternate track label and return new STAR */
 uint32 get_dpatrk(UNIT *uptr, uint32 star, uint8 buf[])
 {
@@ -725,7 +712,7 @@ uint32 get_dpatrk(UNIT *uptr, uint32 star, uint8 buf[])
     uint32  sec=0, trk=0, cyl=0;
     int     type = GET_TYPE(uptr->flags);
     DEVICE  *dptr = get_dev(uptr);
-    int     unit = (uptr - dptr->units);        /* get the UNIT number */
+    struct  _trk_cache *tc = trk_cache(uptr, SPT(type)*SSB(type));  /* label cache */
     int     len, i, cn, found = -1;
 
     /* zero the Track Label Buffer */
@@ -750,13 +737,14 @@ uint32 get_dpatrk(UNIT *uptr, uint32 star, uint8 buf[])
     offset = CAPB(type) + (tstart * 30);
 
     /* see if track label is in cache */
-    for (cn=0; cn<TRK_CACHE; cn++) {
-        if (offset == tkl_label[unit].tkl[cn].track) {
+    for (cn=0; (tc != NULL) && (cn<TRK_CACHE); cn++) {
+        if (offset == tc->lab.tkl[cn].track) {
             /* we found it, copy data to buf */
             for (i=0; i<30; i++)
-                buf[i] = tkl_label[unit].tkl[cn].label[i];
+                buf[i] = tc->lab.tkl[cn].label[i];
             found = cn;
-            tkl_label[unit].tkl[cn].age++;
+            tc->lab.tkl[cn].age++;
+            tc->lhits++;
             sim_debug(DEBUG_EXP, dptr, "get_dpatrk found in Cache to %06x\n", offset);
             break;
         }
@@ -802,25 +790,25 @@ uint32 get_dpatrk(UNIT *uptr, uint32 star, uint8 buf[])
             "Track %08x is defective, new track %08x\n", tstart, nstar);
     }
     /* see if we had it in our cache */
-    if (found == -1) {
+    if ((found == -1) && (tc != NULL)) {
         /* not in our cache, save the new track label */
+        /* use a free entry, else replace the least used one */
         int32 na = 0;
         for (cn=0; cn<TRK_CACHE; cn++) {
             /* see if in use yet */
-            if (tkl_label[unit].tkl[cn].age == 0) {
+            if (tc->lab.tkl[cn].age == 0) {
                 na = cn;                        /* use this one */
                 break;
             }
-            if (tkl_label[unit].tkl[cn].age > na)
-                continue;                       /* older */
-            /* this is less used, so replace it */
-            na = cn;
+            if (tc->lab.tkl[cn].age < tc->lab.tkl[na].age)
+                na = cn;                        /* this one is less used */
         }
         /* use na entry */
         for (i=0; i<30; i++)
-            tkl_label[unit].tkl[na].label[i] = buf[i];
-        tkl_label[unit].tkl[na].age = 1;
-        tkl_label[unit].tkl[cn].track = offset;
+            tc->lab.tkl[na].label[i] = buf[i];
+        tc->lab.tkl[na].age = 1;
+        tc->lab.tkl[na].track = offset;
+        tc->lmisses++;
     }
     return nstar;                               /* return track address */
 }
@@ -1255,7 +1243,7 @@ t_stat hsdp_srv(UNIT *uptr)
     uint32          mema, ecc, cecc, tstar;     /* memory address */
     uint8           ch;
     uint16          ssize = hsdp_type[type].ssiz * 4;   /* disk sector size in bytes */
-    uint32          tstart;
+    uint32          tstart, toff;
     uint8           lbuf[32];
     uint8           buf2[1024];
     uint8           buf[1024];
@@ -2020,20 +2008,12 @@ iha_error:
                 break;
             }
 
-            /* just seek to the location where we will r/w data */
-            if ((sim_fseek(uptr->fileref, tstart, SEEK_SET)) != 0) {  /* do seek */
-                sim_debug(DEBUG_EXP, dptr, "hsdp_srv READ, Error on seek to %04x\n", tstart);
-                uptr->CMD &= LMASK;             /* remove old status bits & cmd */
-                chan_end(chsa, SNS_CHNEND|SNS_DEVEND|SNS_UNITCHK);
-                break;
-            }
-
             sim_debug(DEBUG_CMD, dptr,
                 "HSDP READ reading CMD %08x chsa %04x tstart %04x buffer %06x count %04x\n",
                 uptr->CMD, chsa, tstart, chp->ccw_addr, chp->ccw_count);
 
-            /* read in a sector of data from disk */
-            if ((len=sim_fread(buf, 1, ssize, uptr->fileref)) != ssize) {
+            /* read in a sector of data through the track cache */
+            if ((len=trk_cache_read(uptr, SPT(type)*SSB(type), tstart, buf, ssize)) != ssize) {
                 sim_debug(DEBUG_CMD, dptr,
                     "Error %08x on read %04x of diskfile cyl %04x hds %02x sec %02x\n",
                     len, ssize, ((uptr->CHS)>>16)&0xffff, ((uptr->CHS)>>8)&0xff, (uptr->CHS)&0xff);
@@ -2268,6 +2248,7 @@ iha_error:
                 }
                 buf2[i] = ch;                   /* save the char */
             }
+            toff = tstart;                      /* file offset of sector */
 
             /* get file offset in sectors */
             tstart = STAR2SEC(uptr->CHS, SPT(type), SPC(type));
@@ -2283,6 +2264,7 @@ iha_error:
                 chan_end(chsa, SNS_CHNEND|SNS_DEVEND|SNS_UNITCHK);
                 break;
             }
+            trk_cache_write(uptr, toff, buf2, ssize); /* update track cache */
 
             sim_debug(DEBUG_CMD, dptr,
                 "hsdp_srv after WRITE buffer %06x count %04x\n",
@@ -2590,6 +2572,7 @@ iha_error:
                 return SCPE_OK;
                 break;
             }
+            trk_cache_write(uptr, tstart, buf, 30); /* update track cache */
 
             /* leave STAR "unnormalized" for diags */
             uptr->CHS++;                        /* bump to next sector */
@@ -2851,14 +2834,16 @@ iha_error:
             chan_end(chsa, SNS_CHNEND|SNS_DEVEND|SNS_UNITCHK);
             break;
         }
+        trk_cache_write(uptr, tstart, buf, 30); /* update track cache */
 
         /* clear cache entry for this track */
         /* see if track label is in cache */
-        for (i=0; i<TRK_CACHE; i++) {
-            if (tstart == tkl_label[unit].tkl[i].track) {
+        for (i=0; (uptr->up7 != NULL) && (i<TRK_CACHE); i++) {
+            struct _trk_cache *tc = (struct _trk_cache *)uptr->up7;
+            if (tstart == tc->lab.tkl[i].track) {
                 /* we found it, clear the entry */
-                tkl_label[unit].tkl[i].age = 0;
-                tkl_label[unit].tkl[i].track = 0;
+                tc->lab.tkl[i].age = 0;
+                tc->lab.tkl[i].track = 0;
                 sim_debug(DEBUG_EXP, dptr, "WTL clearing Cache to %06x\n", tstart);
                 break;
             }
@@ -2890,9 +2875,7 @@ iha_error:
 void hsdp_ini(UNIT *uptr, t_bool f)
 {
     DEVICE  *dptr = get_dev(uptr);
-    int     unit = (uptr - dptr->units);        /* get the UNIT number */
     int     i = GET_TYPE(uptr->flags);
-    int     cn;
 
     /* start out at sector 0 */
     uptr->CHS = 0;                              /* set CHS to cyl/hd/sec = 0 */
@@ -2900,11 +2883,7 @@ void hsdp_ini(UNIT *uptr, t_bool f)
     /* total sectors on disk */
     uptr->capac = CAP(i);                       /* size in sectors */
     sim_cancel(uptr);                           /* stop any timer */
-    /* reset track label cache */
-    for (cn=0; cn<TRK_CACHE; cn++) {
-        tkl_label[unit].tkl[cn].track = 0;
-        tkl_label[unit].tkl[cn].age = 0;
-    }
+    trk_cache_inval(uptr);                      /* reset track cache */
 
     sim_debug(DEBUG_EXP, dptr, "DPA init device %s on unit DPA%.1x cap %x %d\n",
         dptr->name, GET_UADDR(uptr->CMD), uptr->capac, uptr->capac);
@@ -2923,14 +2902,10 @@ t_stat  hsdp_rschnlio(UNIT *uptr) {
 
 t_stat hsdp_reset(DEVICE *dptr)
 {
-    int     cn, unit;
+    uint32  unit;
 
-    for (unit=0; unit < NUM_UNITS_HSDP; unit++) {
-        for (cn=0; cn<TRK_CACHE; cn++) {
-            tkl_label[unit].tkl[cn].track = 0;
-            tkl_label[unit].tkl[cn].age = 0;
-        }
-    }
+    for (unit=0; unit < dptr->numunits; unit++)
+        trk_cache_inval(&dptr->units[unit]);    /* reset track cache */
     /* add more reset code here */
     return SCPE_OK;
 }
@@ -3668,6 +3643,7 @@ ldone:
 
 /* detach a disk device */
 t_stat hsdp_detach(UNIT *uptr) {
+    trk_cache_free(uptr);                       /* drop the track cache */
     uptr->SNS = 0;                              /* clear sense data */
     uptr->CMD &= LMASK;                         /* remove old status bits & cmd */
     return detach_unit(uptr);                   /* tell simh we are done with disk */
@@ -3726,6 +3702,7 @@ t_stat hsdp_set_type(UNIT *uptr, int32 val, CONST char *cptr, void *desc)
     return SCPE_ARG;
 }
 
+
 t_stat hsdp_get_type(FILE *st, UNIT * uptr, int32 v, CONST void *desc)
 {
     if (uptr == NULL)
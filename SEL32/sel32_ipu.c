@@ -547,6 +547,46 @@ LOCAL void unlock_mutex()
         pthread_mutex_unlock((pthread_mutex_t *)&(IPC->mutex));
     }
 }
+/* take the async trap posted by the peer, zero if none */
+LOCAL int take_atrap()
+{
+    int32   trap;
+
+    do {
+        trap = IPC->atrap[MyIndex];                 /* get trap number */
+    } while (trap && !sim_shmem_atomic_cas(&IPC->atrap[MyIndex], trap, 0));
+    return trap;
+}
+
+/* post an async trap to the peer, zero if one is still pending */
+/* the mutex is only taken when the peer is asleep waiting for it */
+LOCAL int post_atrap(int32 trap)
+{
+    if (!sim_shmem_atomic_cas(&IPC->atrap[PeerIndex], 0, trap))
+        return 0;                                   /* previous atrap not taken yet */
+    if (sim_shmem_atomic_add(&IPC->sleeping[PeerIndex], 0)) {
+        lock_mutex();                               /* lock mutex */
+        pthread_cond_broadcast(&IPC->cond);         /* wake the waiter */
+        unlock_mutex();                             /* unlock mutex */
+        IPC->wakeups[MyIndex]++;                    /* count the wakeup */
+    }
+    return 1;
+}
+
+/* sleep until the peer posts an async trap */
+LOCAL void wait_atrap()
+{
+    uint32  start = sim_os_msec();
+
+    lock_mutex();                                   /* lock mutex */
+    sim_shmem_atomic_add(&IPC->sleeping[MyIndex], 1);
+    while (IPC->atrap[MyIndex] == 0)                /* sleep on the condition */
+        pthread_cond_wait(&IPC->cond, &IPC->mutex); /* wait for wakeup */
+    sim_shmem_atomic_add(&IPC->sleeping[MyIndex], -1);
+    unlock_mutex();                                 /* unlock mutex and continue */
+    IPC->sleeps[MyIndex]++;                         /* count the wait */
+    IPC->sleepms[MyIndex] += sim_os_msec() - start;
+}
 #endif
 
 #ifdef NOT_USED
@@ -1973,10 +2013,7 @@ cond_ok:
                 /* we are unblocked, look for SIPU */
                 /* we have a trap available, lock and get it */
                 if (IPC && IPC->atrap[MyIndex]) {
-                    lock_mutex();                   /* lock mutex */
-                    TRAPME = IPC->atrap[MyIndex];   /* get trap number */
-                    IPC->atrap[MyIndex] = 0;        /* clear trap value location */
-                    unlock_mutex();                 /* unlock mutex */
+                    TRAPME = take_atrap();          /* get and clear trap number */
                     IPC->received[MyIndex]++;       /* count it received */
                     wait4sipu = 0;                  /* wait is over for sipu */
                     sim_debug(DEBUG_TRAP, my_dev, "IPU: (%d) Async TRAP %02x SPAD[0xf0] %02x rec'd %08x\n",
@@ -1993,10 +2030,7 @@ cond_ok:
             }
             /* unblocked and locked and no async trap */
             if (wait4sipu) {                        /* are we to wait */
-                lock_mutex();                       /* lock mutex */
-                while (IPC->atrap[MyIndex]==0)      /* sleep on the condition */
-                    pthread_cond_wait(&IPC->cond, &IPC->mutex); /* wait for wakeup */
-                unlock_mutex();                     /* unlock mutex and continue */
+                wait_atrap();                       /* sleep until peer posts a trap */
                 goto cond_ok;                       /* continue waiting */
             }
             /* not waiting for sipu, so continue processing */
@@ -2729,11 +2763,7 @@ exec2:
                         //GR  Give it a millisec to unblock the atrap
                         sim_os_ms_sleep(10);        /* wait 10 ms */
                     }
-                    if (IPC->atrap[PeerIndex] == 0) {
-                        lock_mutex();               /* lock mutex */
-                        IPC->atrap[PeerIndex] = SIGNALIPU_TRAP;
-                        pthread_cond_signal(&IPC->cond);    /* wake any waiters */
-                        unlock_mutex();             /* unlock mutex */
+                    if (post_atrap(SIGNALIPU_TRAP)) {
                         IPC->sent[MyIndex]++;
                         sim_debug(DEBUG_TRAP, my_dev,
                             "%s: Async SIPU sent IPUSTATUS %08x CCW %08x SPAD[0xf0] %02x sent %08x\n",
@@ -307,6 +307,8 @@ MTAB            scfi_mod[] = {
     &scfi_set_type, &scfi_get_type, NULL, "Type of disk"},
     {MTAB_XTD | MTAB_VUN | MTAB_VALR, 0, "DEV", "DEV", &set_dev_addr,
         &show_dev_addr, NULL, "Device channel address"},
+    {MTAB_XTD | MTAB_VUN, 0, "CACHE", NULL, NULL,
+        &trk_cache_show, NULL, "Track cache statistics"},
     {0},
 };
 
@@ -411,6 +413,7 @@ uint32 scfisec2star(uint32 daddr, int type)
     return (CHS2STAR(cyl,hds,sec));             /* return STAR */
 }
 
+
 /* start a disk operation */
 t_stat scfi_preio(UNIT *uptr, uint16 chan)
 {
@@ -813,7 +816,7 @@ t_stat scfi_srv(UNIT *uptr)
     uint32          mema;                       /* memory address */
     uint8           ch;
     uint16          ssize = scfi_type[type].ssiz * 4;   /* disk sector size in bytes */
-    uint32          tstart;
+    uint32          tstart, toff;
     uint8           buf[1024];
     uint8           buf2[1024];
 
@@ -1320,20 +1323,12 @@ gohere:
             /* file offset in bytes */
             tstart = tstart * SSB(type);
 
-            /* just seek to the location where we will r/w data */
-            if ((sim_fseek(uptr->fileref, tstart, SEEK_SET)) != 0) {  /* do seek */
-                sim_debug(DEBUG_EXP, dptr, "scfi_srv READ, Error on seek to %04x\n", tstart);
-                uptr->CMD &= LMASK;             /* remove old status bits & cmd */
-                chan_end(chsa, SNS_CHNEND|SNS_DEVEND|SNS_UNITCHK);
-                break;
-            }
-
             sim_debug(DEBUG_CMD, dptr,
                 "DISK READ reading CMD %08x chsa %04x tstart %04x buffer %06x count %04x\n",
                 uptr->CMD, chsa, tstart, chp->ccw_addr, chp->ccw_count);
 
-            /* read in a sector of data from disk */
-            if ((len=sim_fread(buf, 1, ssize, uptr->fileref)) != ssize) {
+            /* read in a sector of data through the track cache */
+            if ((len=trk_cache_read(uptr, SPT(type)*SSB(type), tstart, buf, ssize)) != ssize) {
                 sim_debug(DEBUG_EXP, dptr,
                     "Error %08x on read %04x of diskfile cyl %04x hds %02x sec %02x\n",
                     len, ssize, ((uptr->CHS)>>16)&0xffff, ((uptr->CHS)>>8)&0xff, (uptr->CHS)&0xff);
@@ -1467,6 +1462,7 @@ gohere:
                 }
                 buf2[i] = ch;                   /* save the char */
             }
+            toff = tstart;                      /* file offset of sector */
 
             /* get file offset in sectors */
             tstart = uptr->CHS;
@@ -1480,6 +1476,7 @@ gohere:
                 chan_end(chsa, SNS_CHNEND|SNS_DEVEND|SNS_UNITCHK);
                 break;
             }
+            trk_cache_write(uptr, toff, buf2, ssize); /* update track cache */
 
             sim_debug(DEBUG_DETAIL, dptr,
                 "scfi_srv after WRITE buffer %06x count %04x data %02x%02x%02x%02x %02x%02x%02x%02x\n",
@@ -1572,6 +1569,7 @@ void scfi_ini(UNIT *uptr, t_bool f)
     /* total sectors on disk */
     uptr->capac = CAP(i);                       /* size in sectors */
     sim_cancel(uptr);                           /* stop any timers */
+    trk_cache_inval(uptr);                      /* reset track cache */
 
     sim_debug(DEBUG_EXP, &sda_dev, "SDA init device %s on unit SDA%04x cap %x %d\n",
         dptr->name, GET_UADDR(uptr->CMD), uptr->capac, uptr->capac);
@@ -1579,7 +1577,10 @@ void scfi_ini(UNIT *uptr, t_bool f)
 
 t_stat scfi_reset(DEVICE *dptr)
 {
-    /* add reset code here */
+    uint32  unit;
+
+    for (unit=0; unit < dptr->numunits; unit++)
+        trk_cache_inval(&dptr->units[unit]);    /* reset track cache */
     return SCPE_OK;
 }
 
@@ -1901,6 +1902,7 @@ ldone:
 
 /* detach a disk device */
 t_stat scfi_detach(UNIT *uptr) {
+    trk_cache_free(uptr);                       /* drop the track cache */
     uptr->SNS = 0;                              /* clear sense data */
     uptr->CMD &= LMASK;                         /* remove old status bits & cmd */
     return detach_unit(uptr);                   /* tell simh we are done with disk */
@@ -1960,6 +1962,7 @@ t_stat scfi_set_type(UNIT *uptr, int32 val, CONST char *cptr, void *desc)
     return SCPE_ARG;
 }
 
+
 t_stat scfi_get_type(FILE *st, UNIT *uptr, int32 v, CONST void *desc)
 {
     if (uptr == NULL)
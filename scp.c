@@ -569,6 +569,7 @@ t_stat dep_addr (int32 flag, const char *cptr, t_addr addr, DEVICE *dptr,
 void fprint_fields (FILE *stream, t_value before, t_value after, BITFIELD* bitdefs);
 t_stat step_svc (UNIT *ptr);
 t_stat runlimit_svc (UNIT *ptr);
+t_stat benchmark_svc (UNIT *ptr);
 t_stat expect_svc (UNIT *ptr);
 t_stat flush_svc (UNIT *ptr);
 t_stat shift_args (char *do_arg[], size_t arg_count);
@@ -622,6 +623,10 @@ BRKTAB **sim_brk_tab = NULL;
 int32 sim_brk_ent = 0;
 int32 sim_brk_lnt = 0;
 int32 sim_brk_ins = 0;
+#define SIM_BRK_MAP_BITS        16                      /* log2 address filter bits */
+#define SIM_BRK_HASH(a)         ((uint32)((a) ^ ((a) >> SIM_BRK_MAP_BITS)) & ((1u << SIM_BRK_MAP_BITS) - 1))
+static uint32 sim_brk_map[(1 << SIM_BRK_MAP_BITS) / 32];
+uint32 sim_brk_page_map[1 << SIM_BRK_N_PAGE];
 int32 sim_quiet = 0;
 int32 sim_show_message = 1;                         /* the message display status of the currently open do file */
 int32 sim_step = 0;
@@ -727,6 +732,22 @@ DEVICE sim_runlimit_dev = {
     NULL, NULL, NULL, NULL, NULL, NULL,
     sim_int_runlimit_description};
 
+static const char *sim_int_benchmark_description (DEVICE *dptr)
+{
+return "Benchmark facility";
+}
+
+static t_stat sim_int_benchmark_reset (DEVICE *dptr);
+
+static UNIT sim_benchmark_unit = { UDATA (&benchmark_svc, 0, 0) };
+DEVICE sim_benchmark_dev = {
+    "INT-BENCHMARK", &sim_benchmark_unit, NULL, NULL,
+    1, 0, 0, 0, 0, 0,
+    NULL, NULL, &sim_int_benchmark_reset, NULL, NULL, NULL,
+    NULL, DEV_NOSAVE, 0,
+    NULL, NULL, NULL, NULL, NULL, NULL,
+    sim_int_benchmark_description};
+
 static const char *sim_int_expect_description (DEVICE *dptr)
 {
 return "Expect facility";
@@ -1165,6 +1186,25 @@ static const char simh_help1[] =
       " GO, RUN, CONTINUE, STEP or BOOT commands will cause the simulator to\n"
       " exit.  A previously defined RUNLIMIT can be cleared with the NORUNLIMIT\n"
       " command or the establishment of a new run limit.\n"
+#define HLP_BENCHMARK     "*Commands Stopping_The_Simulator User_Specified_Stop_Conditions BENCHMARK"
+      "4BENCHMARK\n"
+      " The BENCHMARK command runs the current configuration for a fixed amount\n"
+      " of work with idling and throttling suspended, and then reports the\n"
+      " achieved execution rate:\n\n"
+      "++BENCHMARK{-J} {@file} n {%C|MICROSECONDS|SECONDS|MINUTES|HOURS} {cmd}\n\n"
+      " If the units are not specified, the default units are %C.  Execution\n"
+      " starts as a CONTINUE command would, unless a GO, RUN or BOOT command\n"
+      " (with its arguments) follows the length.  The report shows the number\n"
+      " of %C executed, the host elapsed and CPU time, the millions of\n"
+      " %C per second, the events processed per second and the number of\n"
+      " events processed for each device.  The -J switch produces the report as\n"
+      " a single line JSON object, and @file appends the report to file, which\n"
+      " is convenient for tracking results across builds:\n\n"
+      "++BENCHMARK -J @results.json 30 SECONDS BOOT MTA0\n\n"
+      " If the simulator stops for another reason before the length has\n"
+      " elapsed, the report covers the work done up to the stop and includes\n"
+      " the reason.  Sample benchmark scripts are provided with several\n"
+      " simulators' tests as <sim>_bench.ini.\n"
        /***************** 80 character line width template *************************/
       "2Connecting and Disconnecting Devices\n"
       " Except for main memory and network devices, units are simulated as\n"
@@ -2589,6 +2629,7 @@ static CTAB cmd_table[] = {
     { "CURL",       &curl_cmd,      0,          HLP_CURL,       NULL, NULL },
     { "RUNLIMIT",   &runlimit_cmd,  1,          HLP_RUNLIMIT,   NULL, NULL },
     { "NORUNLIMIT", &runlimit_cmd,  0,          HLP_RUNLIMIT,   NULL, NULL },
+    { "BENCHMARK",  &benchmark_cmd, 0,          HLP_BENCHMARK,  NULL, NULL },
     { "TESTLIB",    &test_lib_cmd,  0,          HLP_TESTLIB,    NULL, NULL },
     { "DISKINFO",   &sim_disk_info_cmd,  0,     HLP_DISKINFO,   NULL, NULL },
     { "ZAPTYPE",    &sim_disk_info_cmd,  1,     NULL,           NULL, NULL },
@@ -2858,6 +2899,7 @@ sim_register_internal_device (&sim_expect_dev);
 sim_register_internal_device (&sim_step_dev);
 sim_register_internal_device (&sim_flush_dev);
 sim_register_internal_device (&sim_runlimit_dev);
+sim_register_internal_device (&sim_benchmark_dev);
 
 if ((stat = sim_ttinit ()) != SCPE_OK) {
     fprintf (stderr, "Fatal terminal initialization error\n%s\n",
@@ -7838,6 +7880,17 @@ if (dptr->reset != NULL)
 else return SCPE_OK;
 }
 
+static struct {
+    const char *name;
+    double usec_factor;
+    } time_units[] = {
+        {"MICROSECONDS",             1.0},
+        {"USECONDS",                 1.0},
+        {"SECONDS",            1000000.0},
+        {"MINUTES",         60*1000000.0},
+        {"HOURS",        60*60*1000000.0},
+        {NULL,                       0.0}};
+
 t_stat runlimit_cmd (int32 flag, CONST char *cptr)
 {
 char gbuf[CBUFSIZE];
@@ -7872,16 +7925,6 @@ if ((gbuf[0] == '\0') ||
     }
 else {
     int i;
-    struct {
-        const char *name;
-        double usec_factor;
-        } time_units[] = {
-            {"MICROSECONDS",             1.0},
-            {"USECONDS",                 1.0},
-            {"SECONDS",            1000000.0},
-            {"MINUTES",         60*1000000.0},
-            {"HOURS",        60*60*1000000.0},
-            {NULL,                       0.0}};
 
     for (i=0; time_units[i].name; i++) {
         if (MATCH_CMD (gbuf, time_units[i].name) == 0) {
@@ -7953,6 +7996,228 @@ else
 return SCPE_OK;
 }
 
+/* Benchmark command
+
+   The length of the run is measured by the INT-BENCHMARK unit, whose
+   service routine records the end of the measured interval and stops the
+   simulator.  RUN and BOOT clear the event queue and reset all devices
+   (and with them the simulated time), so the unit's reset routine
+   restarts the measurement when it finds the benchmark pending but not
+   scheduled.
+*/
+
+static struct {
+    t_bool active;                                      /* benchmark in progress */
+    t_bool expired;                                     /* length reached */
+    t_bool timed;                                       /* length is in usecs */
+    double length;                                      /* instructions or usecs */
+    uint32 devcount;                                    /* entries in events */
+    t_uint64 *events;                                   /* device event counts at start */
+    double start_wall, end_wall;                        /* host elapsed seconds */
+    double start_cpu, end_cpu;                          /* host CPU seconds */
+    double start_gtime, end_gtime;                      /* simulated instructions */
+    } sim_bench;
+
+static t_uint64 sim_bench_dev_events (DEVICE *dptr)
+{
+uint32 i;
+t_uint64 events = 0;
+
+for (i = 0; i < dptr->numunits; i++)
+    events += dptr->units[i].event_count;
+return events;
+}
+
+static t_stat sim_bench_start (void)
+{
+uint32 i;
+
+for (i = 0; i < sim_bench.devcount; i++)
+    sim_bench.events[i] = sim_bench_dev_events (sim_devices[i]);
+sim_bench.start_gtime = sim_gtime ();
+sim_bench.start_cpu = ((double)clock ()) / CLOCKS_PER_SEC;
+sim_bench.start_wall = sim_timenow_double ();
+if (sim_bench.timed)
+    return sim_activate_after_d (&sim_benchmark_unit, sim_bench.length);
+return sim_activate (&sim_benchmark_unit, (int32)sim_bench.length);
+}
+
+static void sim_bench_stop (void)
+{
+sim_bench.end_wall = sim_timenow_double ();
+sim_bench.end_cpu = ((double)clock ()) / CLOCKS_PER_SEC;
+sim_bench.end_gtime = sim_gtime ();
+}
+
+static t_stat sim_int_benchmark_reset (DEVICE *dptr)
+{
+if (sim_bench.active && !sim_bench.expired &&
+    !sim_is_active (dptr->units))
+    return sim_bench_start ();
+return SCPE_OK;
+}
+
+t_stat benchmark_svc (UNIT *uptr)
+{
+sim_bench_stop ();
+sim_bench.expired = TRUE;
+return SCPE_STEP | SCPE_NOMESSAGE;
+}
+
+static void sim_bench_report (FILE *st, t_bool json, t_stat stop)
+{
+double wall = sim_bench.end_wall - sim_bench.start_wall;
+double cpu = sim_bench.end_cpu - sim_bench.start_cpu;
+double insts = sim_bench.end_gtime - sim_bench.start_gtime;
+double mips = (wall > 0.0) ? (insts / wall) / 1000000.0 : 0.0;
+t_uint64 events, total = 0;
+const char *stop_text = "";
+uint32 i;
+
+if (!sim_bench.expired) {
+    stop = SCPE_BARE_STATUS (stop);
+    if ((stop > SCPE_OK) && (stop < SCPE_BASE) && (sim_stop_messages[stop] != NULL))
+        stop_text = sim_stop_messages[stop];
+    else
+        stop_text = sim_error_text (stop);
+    }
+
+for (i = 0; i < sim_bench.devcount; i++)
+    total += sim_bench_dev_events (sim_devices[i]) - sim_bench.events[i];
+if (json) {
+    fprintf (st, "{\"simulator\": \"%s\", ", sim_name);
+#if defined(SIM_GIT_COMMIT_ID)
+#define S_xstr(a) S_str(a)
+#define S_str(a) #a
+    fprintf (st, "\"git_commit_id\": \"%s\", ", S_xstr(SIM_GIT_COMMIT_ID));
+#undef S_str
+#undef S_xstr
+#endif
+    fprintf (st, "\"length\": %.0f, \"units\": \"%s\", ", sim_bench.length,
+                 sim_bench.timed ? "microseconds" : sim_vm_interval_units);
+    fprintf (st, "\"completed\": %s, ", sim_bench.expired ? "true" : "false");
+    if (!sim_bench.expired) {
+        fprintf (st, "\"stop\": \"");
+        for (; *stop_text; stop_text++) {
+            if ((*stop_text == '"') || (*stop_text == '\\'))
+                fputc ('\\', st);
+            fputc (*stop_text, st);
+            }
+        fprintf (st, "\", ");
+        }
+    fprintf (st, "\"%s\": %.0f, \"wall_seconds\": %.6f, \"cpu_seconds\": %.6f, ", sim_vm_interval_units, insts, wall, cpu);
+    fprintf (st, "\"mips\": %.3f, \"events\": %" LL_FMT "u, \"events_per_second\": %.1f, \"devices\": {",
+                 mips, (unsigned LL_TYPE)total, (wall > 0.0) ? (double)total / wall : 0.0);
+    for (i = 0, total = 0; i < sim_bench.devcount; i++) {
+        events = sim_bench_dev_events (sim_devices[i]) - sim_bench.events[i];
+        if (events == 0)
+            continue;
+        fprintf (st, "%s\"%s\": %" LL_FMT "u", total++ ? ", " : "", sim_devices[i]->name, (unsigned LL_TYPE)events);
+        }
+    fprintf (st, "}}\n");
+    return;
+    }
+if (!sim_bench.expired)
+    fprintf (st, "Benchmark stopped early: %s\n", stop_text);
+fprintf (st, "%s:%*s%s\n", sim_vm_interval_units, (int)(20 - strlen (sim_vm_interval_units)), "", sim_fmt_numeric (insts));
+fprintf (st, "Elapsed time:        %s\n", sim_fmt_secs (wall));
+fprintf (st, "Host CPU time:       %s\n", sim_fmt_secs (cpu));
+fprintf (st, "MIPS:                %.3f\n", mips);
+fprintf (st, "Events:              %s\n", sim_fmt_numeric ((double)total));
+fprintf (st, "Events/second:       %s\n", sim_fmt_numeric ((wall > 0.0) ? (double)total / wall : 0.0));
+for (i = 0; i < sim_bench.devcount; i++) {
+    events = sim_bench_dev_events (sim_devices[i]) - sim_bench.events[i];
+    if (events)
+        fprintf (st, "  %-16s   %s\n", sim_devices[i]->name, sim_fmt_numeric ((double)events));
+    }
+}
+
+t_stat benchmark_cmd (int32 flag, CONST char *cptr)
+{
+char gbuf[CBUFSIZE];
+int32 num, run_flag = RU_CONT;
+t_stat r;
+t_bool json;
+FILE *ofile;
+int i;
+
+cptr = get_sim_opt (CMD_OPT_SW|CMD_OPT_OF, cptr, &r);  /* get sw, ofile */
+if (!cptr)                                              /* error? */
+    return r;
+json = ((sim_switches & SWMASK ('J')) != 0);
+ofile = sim_ofile;
+sim_ofile = NULL;
+cptr = get_glyph (cptr, gbuf, 0);                       /* get length */
+num = (int32) get_uint (gbuf, 10, INT_MAX, &r);
+if ((r != SCPE_OK) || (num == 0)) {                     /* error? */
+    if (ofile)
+        fclose (ofile);
+    return sim_messagef (SCPE_ARG, "Invalid benchmark length: %s\n", gbuf);
+    }
+memset (&sim_bench, 0, sizeof (sim_bench));
+sim_bench.length = num;
+cptr = get_glyph (cptr, gbuf, 0);                       /* get units */
+if ((gbuf[0] != '\0') &&
+    (MATCH_CMD (gbuf, sim_vm_interval_units) != 0)) {
+    for (i=0; time_units[i].name; i++) {
+        if (MATCH_CMD (gbuf, time_units[i].name) == 0) {
+            sim_bench.timed = TRUE;
+            sim_bench.length = num * time_units[i].usec_factor;
+            cptr = get_glyph (cptr, gbuf, 0);           /* get run command */
+            break;
+            }
+        }
+    }
+else
+    cptr = get_glyph (cptr, gbuf, 0);                   /* get run command */
+if (gbuf[0] != '\0') {
+    if (MATCH_CMD (gbuf, "GO") == 0)
+        run_flag = RU_GO;
+    else if (MATCH_CMD (gbuf, "RUN") == 0)
+        run_flag = RU_RUN;
+    else if (MATCH_CMD (gbuf, "BOOT") == 0)
+        run_flag = RU_BOOT;
+    else if (MATCH_CMD (gbuf, "CONTINUE") != 0) {
+        if (ofile)
+            fclose (ofile);
+        return sim_messagef (SCPE_ARG, "Invalid benchmark units or command: %s\n", gbuf);
+        }
+    }
+for (sim_bench.devcount = 0; sim_devices[sim_bench.devcount]; sim_bench.devcount++);
+sim_bench.events = (t_uint64 *)calloc (sim_bench.devcount, sizeof (*sim_bench.events));
+if (sim_bench.events == NULL) {
+    if (ofile)
+        fclose (ofile);
+    return SCPE_MEM;
+    }
+sim_timer_benchmark (TRUE);                             /* no idling or throttling */
+sim_bench.active = TRUE;
+r = sim_bench_start ();
+if (r == SCPE_OK)
+    r = run_cmd (run_flag, cptr);
+sim_cancel (&sim_benchmark_unit);
+sim_bench.active = FALSE;
+sim_timer_benchmark (FALSE);                            /* restore idling and throttling */
+if (!sim_bench.expired)
+    sim_bench_stop ();
+if (!sim_bench.expired)
+    run_cmd_message (NULL, r);                          /* report why it stopped */
+if (ofile)
+    sim_bench_report (ofile, json, r);
+else {
+    sim_bench_report (stdout, json, r);
+    if (sim_log && (sim_log != stdout))
+        sim_bench_report (sim_log, json, r);
+    }
+free (sim_bench.events);
+sim_bench.events = NULL;
+if (ofile)
+    fclose (ofile);
+if (sim_bench.expired)
+    return SCPE_OK;
+return r | SCPE_NOMESSAGE;
+}
+
 /* Reset devices start..end
 
    Inputs:
@@ -11973,6 +12238,7 @@ do {
         }
     else {
         sim_debug (SIM_DBG_EVENT, &sim_scp_dev, "Processing Event for %s\n", sim_uname (uptr));
+        ++uptr->event_count;
         if (uptr->action != NULL)
             reason = uptr->action (uptr);
         else
@@ -12360,6 +12626,14 @@ return cnt;
    is the bitwise OR of all the type fields).  A simulator need only check for
    a breakpoint of type X if bit SWMASK('X') is set in sim_brk_summ.
 
+   Two address filters are kept in step with the table.  sim_brk_map has
+   one bit per hashed address, so sim_brk_test rejects an address which has
+   no breakpoint with a single load instead of a table search.
+   sim_brk_page_map holds the bitwise OR of the types of the breakpoints
+   within each page of addresses; the sim_brk_watch macro uses it so a
+   simulator can check data references for watch breakpoints without
+   calling sim_brk_test for pages which aren't being watched.
+
    The package contains the following public routines:
 
         sim_brk_init            initialize
@@ -12398,11 +12672,41 @@ if (sim_brk_tab == NULL)
     return SCPE_MEM;
 memset (sim_brk_tab, 0, sim_brk_lnt*sizeof (BRKTAB*));
 sim_brk_ent = sim_brk_ins = 0;
+memset (sim_brk_map, 0, sizeof (sim_brk_map));
+memset (sim_brk_page_map, 0, sizeof (sim_brk_page_map));
 sim_brk_clract ();
 sim_brk_npc (0);
 return SCPE_OK;
 }
 
+/* Add a breakpoint to the address filters */
+
+static void sim_brk_map_add (t_addr loc, uint32 btyp)
+{
+uint32 h = SIM_BRK_HASH (loc);
+
+sim_brk_map[h >> 5] |= (1u << (h & 31));
+sim_brk_page_map[SIM_BRK_PAGE (loc)] |= (btyp & ~BRK_TYP_TEMP);
+}
+
+/* Recalculate the type summary and address filters from the table */
+
+static void sim_brk_map_update (void)
+{
+int32 i;
+BRKTAB *bp;
+
+sim_brk_summ = 0;
+memset (sim_brk_map, 0, sizeof (sim_brk_map));
+memset (sim_brk_page_map, 0, sizeof (sim_brk_page_map));
+for (i = 0; i < sim_brk_ent; i++) {
+    for (bp = sim_brk_tab[i]; bp; bp = bp->next) {
+        sim_brk_summ |= (bp->typ & ~BRK_TYP_TEMP);
+        sim_brk_map_add (bp->addr, bp->typ);
+        }
+    }
+}
+
 /* Search for a breakpoint in the sorted breakpoint table */
 
 BRKTAB *sim_brk_fnd (t_addr loc)
@@ -12530,6 +12834,7 @@ if ((act != NULL) && (*act != 0)) {                     /* new action? */
     bp->act = newp;                                     /* set pointer */
     }
 sim_brk_summ = sim_brk_summ | (sw & ~BRK_TYP_TEMP);
+sim_brk_map_add (loc, sw);
 return SCPE_OK;
 }
 
@@ -12566,14 +12871,7 @@ if (sim_brk_tab[sim_brk_ins] == NULL) {                 /* erased entry */
     for (i = sim_brk_ins; i < sim_brk_ent; i++)         /* shuffle remaining entries */
         sim_brk_tab[i] = sim_brk_tab[i+1];
     }
-sim_brk_summ = 0;                                       /* recalc summary */
-for (i = 0; i < sim_brk_ent; i++) {
-    bp = sim_brk_tab[i];
-    while (bp) {
-        sim_brk_summ |= (bp->typ & ~BRK_TYP_TEMP);
-        bp = bp->next;
-        }
-    }
+sim_brk_map_update ();                                  /* recalc summary and filters */
 return SCPE_OK;
 }
 
@@ -12712,7 +13010,10 @@ uint32 sim_brk_test (t_addr loc, uint32 btyp)
 {
 BRKTAB *bp;
 uint32 spc = (btyp >> SIM_BKPT_V_SPC) & (SIM_BKPT_N_SPC - 1);
+uint32 h = SIM_BRK_HASH (loc);
 
+if (!(sim_brk_map[h >> 5] & (1u << (h & 31))))          /* no breakpoint here? */
+    return 0;
 if (sim_brk_summ & BRK_TYP_DYN_ALL)
     btyp |= BRK_TYP_DYN_ALL;
 
@@ -13005,6 +13306,22 @@ for (i=start_rule; i<exp->size; i++)
 return NULL;
 }
 
+/* Release the compiled string rule matcher
+
+   The matcher is rebuilt from the rule table the next time output
+   data is checked.
+ */
+
+static void sim_exp_free_matcher (EXPECT *exp)
+{
+free (exp->ac_goto);
+exp->ac_goto = NULL;
+free (exp->ac_rule);
+exp->ac_rule = NULL;
+exp->ac_state = 0;
+exp->ac_dirty = TRUE;
+}
+
 /* Clear (delete) an expect rule */
 
 t_stat sim_exp_clr_tab (EXPECT *exp, EXPTAB *ep)
@@ -13027,6 +13344,7 @@ if (exp->size == 0) {                                   /* No rules left? */
     free (exp->rules);
     exp->rules = NULL;
     }
+sim_exp_free_matcher (exp);                             /* rule indexes have changed */
 return SCPE_OK;
 }
 
@@ -13063,6 +13381,7 @@ free (exp->buf);
 exp->buf = NULL;
 exp->buf_size = 0;
 exp->buf_data = exp->buf_ins = 0;
+sim_exp_free_matcher (exp);
 return SCPE_OK;
 }
 
@@ -13125,6 +13444,7 @@ exp->rules = (EXPTAB *) realloc (exp->rules, sizeof (*exp->rules)*(exp->size + 1
 ep = &exp->rules[exp->size];
 exp->size += 1;
 memset (ep, 0, sizeof(*ep));
+sim_exp_free_matcher (exp);                             /* matcher needs the new rule */
 ep->after = after;                                     /* set halt after value */
 ep->match_pattern = (char *)malloc (strlen (match) + 1);
 if (ep->match_pattern)
@@ -13257,158 +13577,231 @@ for (i=0; i < exp->size; i++)
 return SCPE_OK;
 }
 
+/* Build the string rule matcher
+
+   All string (non RegEx) rules are compiled into a single Aho-Corasick
+   automaton with a full 256 entry transition table per state, so the
+   output data advances one state per byte regardless of how many rules
+   are active.  Each state records the lowest numbered rule whose match
+   string ends there, which preserves the rule table order when several
+   rules match the same data.  The current state is recovered by running
+   the data which has accumulated since the last match through the new
+   automaton.
+ */
+
+static t_stat sim_exp_build_matcher (EXPECT *exp)
+{
+size_t i, states = 1, head, tail;
+uint32 s, next, *fail, *queue;
+int c;
+
+sim_exp_free_matcher (exp);
+exp->ac_dirty = FALSE;
+exp->regex_count = 0;
+for (i=0; i<exp->size; i++) {
+    if (exp->rules[i].switches & EXP_TYP_REGEX)
+        ++exp->regex_count;
+    else
+        states += exp->rules[i].size;
+    }
+if (exp->regex_count == exp->size)                      /* No string rules? */
+    return SCPE_OK;
+exp->ac_goto = (uint32 *)calloc (states * 256, sizeof (*exp->ac_goto));
+exp->ac_rule = (int32 *)malloc (states * sizeof (*exp->ac_rule));
+fail = (uint32 *)calloc (states, sizeof (*fail));
+queue = (uint32 *)malloc (states * sizeof (*queue));
+if ((exp->ac_goto == NULL) || (exp->ac_rule == NULL) ||
+    (fail == NULL) || (queue == NULL)) {
+    free (fail);
+    free (queue);
+    sim_exp_free_matcher (exp);
+    return SCPE_MEM;
+    }
+for (i=0; i<states; i++)
+    exp->ac_rule[i] = -1;
+states = 1;
+for (i=0; i<exp->size; i++) {                           /* Build the trie of match strings */
+    EXPTAB *ep = &exp->rules[i];
+    size_t j;
+
+    if (ep->switches & EXP_TYP_REGEX)
+        continue;
+    for (s=0, j=0; j < ep->size; j++) {
+        uint32 *edge = &exp->ac_goto[(s << 8) | ep->match[j]];
+
+        if (*edge == 0)
+            *edge = (uint32)states++;
+        s = *edge;
+        }
+    if (exp->ac_rule[s] < 0)
+        exp->ac_rule[s] = (int32)i;
+    }
+head = tail = 0;                                        /* Breadth first fill in of failure transitions */
+for (c=0; c<256; c++)
+    if (exp->ac_goto[c])
+        queue[tail++] = exp->ac_goto[c];
+while (head < tail) {
+    s = queue[head++];
+    if ((exp->ac_rule[fail[s]] >= 0) &&
+        ((exp->ac_rule[s] < 0) || (exp->ac_rule[fail[s]] < exp->ac_rule[s])))
+        exp->ac_rule[s] = exp->ac_rule[fail[s]];
+    for (c=0; c<256; c++) {
+        next = exp->ac_goto[(s << 8) | c];
+        if (next) {
+            fail[next] = exp->ac_goto[(fail[s] << 8) | c];
+            queue[tail++] = next;
+            }
+        else
+            exp->ac_goto[(s << 8) | c] = exp->ac_goto[(fail[s] << 8) | c];
+        }
+    }
+free (fail);
+free (queue);
+sim_debug (exp->dbit, exp->dptr, "Expect string matcher built: %d rules, %d states\n", (int)(exp->size - exp->regex_count), (int)states);
+for (i=exp->buf_data; i > 0; i--) {                     /* Replay data since the last match */
+    size_t off = (exp->buf_ins + exp->buf_size - i) % exp->buf_size;
+
+    exp->ac_state = exp->ac_goto[(exp->ac_state << 8) | exp->buf[off]];
+    }
+return SCPE_OK;
+}
+
+#if defined (USE_REGEX)
+/* Check a RegEx rule against the match buffer
+
+   Any new match must end with the data just added, so a pattern only
+   needs to be evaluated from the earliest point at which a partial match
+   was still in progress the last time it was checked.  Once no partial
+   match remains, the next check only considers newly arrived data.
+ */
+
+static t_bool sim_exp_regex_check (EXPECT *exp, EXPTAB *ep)
+{
+int *ovector = NULL;
+int ovector_elts;
+int rc;
+char *cbuf = (char *)exp->buf;
+static size_t sim_exp_match_sub_count = 0;
+
+if (ep->re_start > exp->buf_ins)
+    ep->re_start = exp->buf_ins;
+ovector_elts = 3 * (ep->re_nsub + 1);
+ovector = (int *)calloc ((size_t) ovector_elts, sizeof(*ovector));
+if (sim_deb && exp->dptr && (exp->dptr->dctrl & exp->dbit)) {
+    char *estr = sim_encode_quoted_string (&exp->buf[ep->re_start], exp->buf_ins - ep->re_start);
+    sim_debug (exp->dbit, exp->dptr, "Checking String[%" SIZE_T_FMT "u:]: %s\n", ep->re_start, estr);
+    sim_debug (exp->dbit, exp->dptr, "Against RegEx Match Rule: %s\n", ep->match_pattern);
+    free (estr);
+    }
+/* exp->buf_ins is never going to exceed 1024 (current limit), so this is safe to
+   downcast to int. */
+#if defined (PCRE_PARTIAL_SOFT)
+rc = pcre_exec (ep->regex, NULL, cbuf, (int) exp->buf_ins, (int) ep->re_start, PCRE_NOTBOL | PCRE_PARTIAL_SOFT, ovector, ovector_elts);
+if (rc == PCRE_ERROR_PARTIAL)                           /* match may still complete? */
+    ep->re_start = (size_t)ovector[0];                  /* resume there next time */
+#else
+rc = pcre_exec (ep->regex, NULL, cbuf, (int) exp->buf_ins, 0, PCRE_NOTBOL, ovector, ovector_elts);
+#endif
+if (rc == PCRE_ERROR_NOMATCH)
+    ep->re_start = exp->buf_ins;                        /* nothing pending */
+if (rc >= 0) {
+    size_t j;
+    char *buf = (char *)malloc (1 + exp->buf_ins);
+
+    for (j=0; j < (size_t)rc; j++) {
+        char env_name[32];
+        int end_offs = ovector[2 * j + 1], start_offs = ovector[2 * j];
+
+        sprintf (env_name, "_EXPECT_MATCH_GROUP_%d", (int)j);
+        if (start_offs >= 0 && end_offs >= start_offs) {
+            memcpy (buf, &cbuf[start_offs], end_offs - start_offs);
+            buf[end_offs - start_offs] = '\0';
+            setenv (env_name, buf, 1);      /* Make the match and substrings available as environment variables */
+            sim_debug (exp->dbit, exp->dptr, "%s=%s\n", env_name, buf);
+            }
+        else {
+            /* Substring was not captured by regexp: remove from the environment
+             * (unsetenv is local static -- doesn't actually remove the variable from
+             * the environment, sets it to an empty string.) */
+            sim_debug (exp->dbit, exp->dptr, "unsetenv %s\n", env_name);
+            unsetenv(env_name);
+            }
+        }
+    for (; j<sim_exp_match_sub_count; j++) {
+        char env_name[32];
+
+        sprintf (env_name, "_EXPECT_MATCH_GROUP_%d", (int)j);
+        setenv (env_name, "", 1);      /* Remove previous extra environment variables */
+        }
+    sim_exp_match_sub_count = ep->re_nsub;
+    free (buf);
+    }
+free (ovector);
+return (rc >= 0);
+}
+#endif
+
 /* Test for expect match */
 
 t_stat sim_exp_check (EXPECT *exp, uint8 data)
 {
 size_t i;
+#if defined (USE_REGEX)
+size_t r;
+#endif
 EXPTAB *ep = NULL;
-int regex_checks = 0;
-char *tstr = NULL;
 
 if ((!exp) || (!exp->rules))                            /* Anything to check? */
     return SCPE_OK;
 
-exp->buf[exp->buf_ins++] = data;                        /* Save new data */
-exp->buf[exp->buf_ins] = '\0';                          /* Nul terminate for RegEx match */
-if (exp->buf_data < exp->buf_size)
-    ++exp->buf_data;                                    /* Record amount of data in buffer */
+if (exp->ac_dirty) {                                    /* Rules changed? */
+    t_stat r = sim_exp_build_matcher (exp);
 
-for (i=0; i < exp->size; i++) {
-    ep = &exp->rules[i];
-    if (ep->switches & EXP_TYP_REGEX) {
-#if defined (USE_REGEX)
-        int *ovector = NULL;
-        int ovector_elts;
-        int rc;
-        char *cbuf = (char *)exp->buf;
-        static size_t sim_exp_match_sub_count = 0;
-
-        if (tstr)
-            cbuf = tstr;
-        else {
-            if (strlen ((char *)exp->buf) != exp->buf_ins) { /* Nul characters in buffer? */
-                size_t off;
-
-                tstr = (char *)malloc (exp->buf_ins + 1);
-                tstr[0] = '\0';
-                for (off=0; off < exp->buf_ins; off += 1 + strlen ((char *)&exp->buf[off]))
-                    strcpy (&tstr[strlen (tstr)], (char *)&exp->buf[off]);
-                cbuf = tstr;
-                }
-            }
-        ++regex_checks;
-        ovector_elts = 3 * (ep->re_nsub + 1);
-        ovector = (int *)calloc ((size_t) ovector_elts, sizeof(*ovector));
-        if (sim_deb && exp->dptr && (exp->dptr->dctrl & exp->dbit)) {
-            char *estr = sim_encode_quoted_string (exp->buf, exp->buf_ins);
-            sim_debug (exp->dbit, exp->dptr, "Checking String: %s\n", estr);
-            sim_debug (exp->dbit, exp->dptr, "Against RegEx Match Rule: %s\n", ep->match_pattern);
-            free (estr);
-            }
-        /* exp->buf_ins is never going to exceed 1024 (current limit), so this is safe to
-           downcast to int. */
-        rc = pcre_exec (ep->regex, NULL, cbuf, (int) exp->buf_ins, 0, PCRE_NOTBOL, ovector, ovector_elts);
-        if (rc >= 0) {
-            size_t j;
-            char *buf = (char *)malloc (1 + exp->buf_ins);
-
-            for (j=0; j < (size_t)rc; j++) {
-                char env_name[32];
-                int end_offs = ovector[2 * j + 1], start_offs = ovector[2 * j];
-
-                sprintf (env_name, "_EXPECT_MATCH_GROUP_%d", (int)j);
-                if (start_offs >= 0 && end_offs >= start_offs) {
-                    memcpy (buf, &cbuf[start_offs], end_offs - start_offs);
-                    buf[end_offs - start_offs] = '\0';
-                    setenv (env_name, buf, 1);      /* Make the match and substrings available as environment variables */
-                    sim_debug (exp->dbit, exp->dptr, "%s=%s\n", env_name, buf);
-                    }
-                else {
-                    /* Substring was not captured by regexp: remove from the environment
-                     * (unsetenv is local static -- doesn't actually remove the variable from
-                     * the environment, sets it to an empty string.) */
-                    sim_debug (exp->dbit, exp->dptr, "unsetenv %s\n", env_name);
-                    unsetenv(env_name);
-                    }
-                }
-            for (; j<sim_exp_match_sub_count; j++) {
-                char env_name[32];
+    if (r != SCPE_OK)
+        return r;
+    }
+if ((data != 0) || (exp->regex_count == 0)) {           /* RegEx rules never see NUL data */
+    exp->buf[exp->buf_ins++] = data;                    /* Save new data */
+    exp->buf[exp->buf_ins] = '\0';                      /* Nul terminate for RegEx match */
+    if (exp->buf_data < exp->buf_size)
+        ++exp->buf_data;                                /* Record amount of data in buffer */
+    }
 
-                sprintf (env_name, "_EXPECT_MATCH_GROUP_%d", (int)j);
-                setenv (env_name, "", 1);      /* Remove previous extra environment variables */
-                }
-            sim_exp_match_sub_count = ep->re_nsub;
-            free (ovector);
-            ovector = NULL;
-            free (buf);
-            break;
-            }
-        free (ovector);
-#endif
-        }
-    else {
-        if (exp->buf_data < ep->size)                           /* Too little data to match yet? */
-            continue;                                           /* Yes, Try next one. */
-        if (exp->buf_ins < ep->size) {                          /* Match might straddle end of buffer */
-            /*
-             * First compare the newly deposited data at the beginning
-             * of buffer with the end of the match string
-             */
-            if (exp->buf_ins > 0) {
-                if (sim_deb && exp->dptr && (exp->dptr->dctrl & exp->dbit)) {
-                    char *estr = sim_encode_quoted_string (exp->buf, exp->buf_ins);
-                    char *mstr = sim_encode_quoted_string (&ep->match[ep->size-exp->buf_ins], exp->buf_ins);
-
-                    sim_debug (exp->dbit, exp->dptr, "Checking String[0:%" SIZE_T_FMT "d]: %s\n", exp->buf_ins, estr);
-                    sim_debug (exp->dbit, exp->dptr, "Against Match Data: %s\n", mstr);
-                    free (estr);
-                    free (mstr);
-                    }
-                if (memcmp (exp->buf, &ep->match[ep->size-exp->buf_ins], exp->buf_ins)) /* Tail Match? */
-                    continue;                                   /* Nope, Try next one. */
-                }
-            if (sim_deb && exp->dptr && (exp->dptr->dctrl & exp->dbit)) {
-                char *estr = sim_encode_quoted_string (&exp->buf[exp->buf_size-(ep->size-exp->buf_ins)], ep->size-exp->buf_ins);
-                char *mstr = sim_encode_quoted_string (ep->match, ep->size-exp->buf_ins);
-
-                sim_debug (exp->dbit, exp->dptr, "Checking String[%" SIZE_T_FMT "d:%" SIZE_T_FMT "d]: %s\n",
-                           exp->buf_size - ep->size - exp->buf_ins, ep->size-exp->buf_ins, estr);
-                sim_debug (exp->dbit, exp->dptr, "Against Match Data: %s\n", mstr);
-                free (estr);
-                free (mstr);
-                }
-            if (memcmp (&exp->buf[exp->buf_size-(ep->size-exp->buf_ins)], ep->match, ep->size-exp->buf_ins)) /* Front Match? */
-                continue;                                       /* Nope, Try next one. */
-            break;
-            }
-        else {
-            if (sim_deb && exp->dptr && (exp->dptr->dctrl & exp->dbit)) {
-                char *estr = sim_encode_quoted_string (&exp->buf[exp->buf_ins-ep->size], ep->size);
-                char *mstr = sim_encode_quoted_string (ep->match, ep->size);
-
-                sim_debug (exp->dbit, exp->dptr, "Checking String[%" SIZE_T_FMT "u:%" SIZE_T_FMT "u]: %s\n",
-                          exp->buf_ins - ep->size, ep->size, estr);
-                sim_debug (exp->dbit, exp->dptr, "Against Match Data: %s\n", mstr);
-                free (estr);
-                free (mstr);
-                }
-            if (memcmp (&exp->buf[exp->buf_ins-ep->size], ep->match, ep->size)) /* Whole string match? */
-                continue;                                       /* Nope, Try next one. */
+i = exp->size;                                          /* Presume no match */
+if (exp->ac_goto) {
+    exp->ac_state = exp->ac_goto[(exp->ac_state << 8) | data];
+    if (exp->ac_rule[exp->ac_state] >= 0)               /* String rule matched? */
+        i = (size_t)exp->ac_rule[exp->ac_state];
+    }
+#if defined (USE_REGEX)
+if (exp->regex_count && (data != 0)) {                  /* Earlier RegEx rules take precedence */
+    for (r=0; r < i; r++) {
+        if ((exp->rules[r].switches & EXP_TYP_REGEX) &&
+            sim_exp_regex_check (exp, &exp->rules[r])) {
+            i = r;
             break;
             }
         }
     }
+#endif
+if (i != exp->size)
+    ep = &exp->rules[i];
 if (exp->buf_ins == exp->buf_size) {                    /* At end of match buffer? */
-    if (regex_checks) {
+    if (exp->regex_count) {
+        size_t slide = exp->buf_size/2;
+
         /* When processing regular expressions, let the match buffer fill
            up and then shuffle the buffer contents down by half the buffer size
            so that the regular expression has a single contiguous buffer to
            match against instead of the wrapping buffer paradigm which is
            used when no regular expression rules are in effect */
-        memmove (exp->buf, &exp->buf[exp->buf_size/2], exp->buf_size-(exp->buf_size/2));
-        exp->buf_ins -= exp->buf_size/2;
+        memmove (exp->buf, &exp->buf[slide], exp->buf_size-slide);
+        exp->buf_ins -= slide;
         exp->buf_data = exp->buf_ins;
+#if defined (USE_REGEX)
+        for (r=0; r < exp->size; r++)
+            exp->rules[r].re_start = (exp->rules[r].re_start > slide) ? exp->rules[r].re_start - slide : 0;
+#endif
         sim_debug (exp->dbit, exp->dptr, "Buffer Full - sliding the last %" SIZE_T_FMT "d bytes to start of buffer new insert at: %" SIZE_T_FMT "d\n",
                   exp->buf_size / 2, exp->buf_ins);
         }
@@ -13449,8 +13842,12 @@ if (i != exp->size) {                                   /* Found? */
         }
     /* Matched data is no longer available for future matching */
     exp->buf_data = exp->buf_ins = 0;
+    exp->ac_state = 0;
+#if defined (USE_REGEX)
+    for (i=0; i < exp->size; i++)
+        exp->rules[i].re_start = 0;
+#endif
     }
-free (tstr);
 return SCPE_OK;
 }
 
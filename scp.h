@@ -117,6 +117,7 @@ t_stat echo_cmd (int32 flag, CONST char *ptr);
 t_stat echof_cmd (int32 flag, CONST char *ptr);
 t_stat debug_cmd (int32 flag, CONST char *ptr);
 t_stat runlimit_cmd (int32 flag, CONST char *ptr);
+t_stat benchmark_cmd (int32 flag, CONST char *ptr);
 t_stat tar_cmd (int32 flag, CONST char *ptr);
 t_stat curl_cmd (int32 flag, CONST char *ptr);
 t_stat test_lib_cmd (int32 flag, CONST char *ptr);
@@ -220,6 +221,7 @@ t_stat get_aval (t_addr addr, DEVICE *dptr, UNIT *uptr);
 t_value get_rval (REG *rptr, uint32 idx);
 BRKTAB *sim_brk_fnd (t_addr loc);
 uint32 sim_brk_test (t_addr bloc, uint32 btyp);
+#define sim_brk_watch(loc,btyp) ((sim_brk_summ & (btyp)) && (sim_brk_page_map[SIM_BRK_PAGE (loc)] & (btyp)) && sim_brk_test ((loc), (btyp)))
 void sim_brk_clrspc (uint32 spc, uint32 btyp);
 void sim_brk_npc (uint32 cnt);
 void sim_brk_setact (const char *action);
@@ -329,6 +331,7 @@ extern volatile t_bool stop_cpu;
 extern uint32 sim_brk_types;                            /* breakpoint info */
 extern uint32 sim_brk_dflt;
 extern uint32 sim_brk_summ;
+extern uint32 sim_brk_page_map[];
 extern uint32 sim_brk_match_type;
 extern t_addr sim_brk_match_addr;
 extern BRKTYPTAB *sim_brk_type_desc;                    /* type descriptions */
@@ -471,17 +471,21 @@ t_stat sim_rem_con_poll_svc (UNIT *uptr);               /* remote console connec
 t_stat sim_rem_con_data_svc (UNIT *uptr);               /* remote console connection data routine */
 t_stat sim_rem_con_repeat_svc (UNIT *uptr);             /* remote auto repeat command console timing routine */
 t_stat sim_rem_con_smp_collect_svc (UNIT *uptr);        /* remote remote register data sampling routine */
+t_stat sim_rem_con_publish_svc (UNIT *uptr);            /* remote shared memory register publishing routine */
 t_stat sim_rem_con_reset (DEVICE *dptr);                /* remote console reset routine */
 #define rem_con_poll_unit (&sim_remote_console.units[0])
 #define rem_con_data_unit (&sim_remote_console.units[1])
 #define REM_CON_BASE_UNITS 2
 #define rem_con_repeat_units (&sim_remote_console.units[REM_CON_BASE_UNITS])
 #define rem_con_smp_smpl_units (&sim_remote_console.units[REM_CON_BASE_UNITS+sim_rem_con_tmxr.lines])
+#define rem_con_publish_units (&sim_remote_console.units[REM_CON_BASE_UNITS+2*sim_rem_con_tmxr.lines])
+#define REM_CON_LINE_UNITS 3                            /* units per remote console line */
 
 #define DBG_MOD  0x00000004                             /* Remote Console Mode activities */
 #define DBG_REP  0x00000008                             /* Remote Console Repeat activities */
 #define DBG_SAM  0x00000010                             /* Remote Console Sample activities */
 #define DBG_CMD  0x00000020                             /* Remote Console Command activities */
+#define DBG_PUB  0x00000040                             /* Remote Console Publish activities */
 
 DEBTAB sim_rem_con_debug[] = {
   {"TRC",    DBG_TRC, "routine calls"},
@@ -492,6 +496,7 @@ DEBTAB sim_rem_con_debug[] = {
   {"MODE",   DBG_MOD, "Remote Console Mode activity"},
   {"REPEAT", DBG_REP, "Remote Console Repeat activity"},
   {"SAMPLE", DBG_SAM, "Remote Console Sample activity"},
+  {"PUBLISH",DBG_PUB, "Remote Console Shared Memory Publish activity"},
   {0}
 };
 
@@ -528,6 +533,32 @@ struct BITSAMPLE_REG {
     uint32          width;          /* number of bits to sample */
     BITSAMPLE       *bits;
     };
+typedef struct PUBLISH_REG PUBLISH_REG;
+struct PUBLISH_REG {
+    REG             *reg;           /* Register to be published */
+    uint32          idx;            /* Register index */
+    t_bool          indirect;       /* Register value points at memory */
+    DEVICE          *dptr;          /* Device register is part of */
+    UNIT            *uptr;          /* Unit Register is related to */
+    };
+/*
+   Shared memory register block published by the PUBLISH command.
+   This layout must match SIM_PANEL_SHMEM in sim_frontpanel.h.
+   The sequence counter is odd while the block is being rewritten,
+   readers retry until they see the same even value before and after
+   copying the values.
+ */
+#define PUBLISH_MAGIC   0x53484D50                      /* "SHMP" */
+#define PUBLISH_VERSION 1
+typedef struct PUBLISH_BLOCK PUBLISH_BLOCK;
+struct PUBLISH_BLOCK {
+    uint32          magic;
+    uint32          version;
+    uint32          reg_count;
+    uint32          sequence;       /* odd while update in progress */
+    t_uint64        simulation_time;
+    t_uint64        values[1];      /* reg_count register values */
+    };
 typedef struct REMOTE REMOTE;
 struct REMOTE {
     size_t          buf_size;
@@ -548,6 +579,12 @@ struct REMOTE {
     int             smp_sample_dither_pct;  /* dithering of cycles interval */
     uint32          smp_reg_count;          /* sample register count */
     BITSAMPLE_REG   *smp_regs;              /* registers being sampled */
+    uint32          pub_interval;           /* usecs between shared memory publications */
+    uint32          pub_reg_count;          /* published register count */
+    PUBLISH_REG     *pub_regs;              /* registers being published */
+    SHMEM           *pub_shmem;             /* shared memory segment */
+    PUBLISH_BLOCK   *pub_block;             /* published register block */
+    char            *pub_name;              /* shared memory segment name */
     };
 REMOTE *sim_rem_consoles = NULL;
 
@@ -680,6 +717,8 @@ for (i=connections=0; i<sim_rem_con_tmxr.lines; i++) {
         if (sim_switches & SWMASK ('D'))
             sim_rem_sample_output (st, rem->line);
         }
+    if (rem->pub_reg_count)
+        fprintf (st, "%d Register values are published in shared memory '%s' every %s\n", (int)rem->pub_reg_count, rem->pub_name, sim_fmt_secs (rem->pub_interval / 1000000.0));
     }
 return SCPE_OK;
 }
@@ -758,6 +797,11 @@ static t_stat x_run_cmd (int32 flag, CONST char *cptr)
 return 7+SCPE_IERR;         /* This routine should never be called */
 }
 
+static t_stat x_publish_cmd (int32 flag, CONST char *cptr)
+{
+return 8+SCPE_IERR;         /* This routine should never be called */
+}
+
 static t_stat x_help_cmd (int32 flag, CONST char *cptr);
 
 static CTAB allowed_remote_cmds[] = {
@@ -772,6 +816,7 @@ static CTAB allowed_remote_cmds[] = {
     { "REPEAT",   &x_repeat_cmd,      0 },
     { "COLLECT",  &x_collect_cmd,     0 },
     { "SAMPLEOUT",&x_sampleout_cmd,   0 },
+    { "PUBLISH",  &x_publish_cmd,     0 },
     { "PWD",      &pwd_cmd,           0 },
     { "SAVE",     &save_cmd,          0 },
     { "DIR",      &dir_cmd,           0 },
@@ -797,6 +842,7 @@ static CTAB allowed_master_remote_cmds[] = {
     { "REPEAT",   &x_repeat_cmd,      0 },
     { "COLLECT",  &x_collect_cmd,     0 },
     { "SAMPLEOUT",&x_sampleout_cmd,   0 },
+    { "PUBLISH",  &x_publish_cmd,     0 },
     { "EXECUTE",  &x_execute_cmd,     0 },
     { "PWD",      &pwd_cmd,           0 },
     { "SAVE",     &save_cmd,          0 },
@@ -831,6 +877,7 @@ static CTAB allowed_single_remote_cmds[] = {
     { "REPEAT",   &x_repeat_cmd,      0 },
     { "COLLECT",  &x_collect_cmd,     0 },
     { "SAMPLEOUT",&x_sampleout_cmd,   0 },
+    { "PUBLISH",  &x_publish_cmd,     0 },
     { "EXECUTE",  &x_execute_cmd,     0 },
     { "PWD",      &pwd_cmd,           0 },
     { "DIR",      &dir_cmd,           0 },
@@ -848,6 +895,7 @@ static CTAB remote_only_cmds[] = {
     { "REPEAT",   &x_repeat_cmd,      0 },
     { "COLLECT",  &x_collect_cmd,     0 },
     { "SAMPLEOUT",&x_sampleout_cmd,   0 },
+    { "PUBLISH",  &x_publish_cmd,     0 },
     { "EXECUTE",  &x_execute_cmd,     0 },
     { NULL,       NULL }
     };
@@ -1377,6 +1425,198 @@ if (rem->smp_sample_interval && (rem->smp_reg_count != 0)) {
 return SCPE_OK;
 }
 
+static void sim_rem_publish_registers (REMOTE *rem)
+{
+PUBLISH_BLOCK *blk = rem->pub_block;
+uint32 i;
+
+sim_shmem_atomic_add ((int32 *)&blk->sequence, 1);      /* odd: update in progress */
+blk->simulation_time = (t_uint64)sim_gtime ();
+for (i = 0; i < rem->pub_reg_count; i++) {
+    PUBLISH_REG *preg = &rem->pub_regs[i];
+    t_value val = get_rval (preg->reg, preg->idx);
+
+    if (preg->indirect)
+        val = (get_aval ((t_addr)val, preg->dptr, preg->uptr) == SCPE_OK) ? sim_eval[0] : 0;
+    blk->values[i] = (t_uint64)val;
+    }
+sim_shmem_atomic_add ((int32 *)&blk->sequence, 1);      /* even: update complete */
+}
+
+/*
+    Parse and setup Remote Console PUBLISH command:
+       PUBLISH name EVERY nnn USECS reg{,reg...}
+       PUBLISH STOP
+
+    Register values are written to the shared memory segment
+    'name' so that a front panel can read them without any
+    command or text parsing overhead.  Array registers may be
+    given a subscript range reg[lo:hi].
+ */
+static t_stat sim_rem_publish_cmd_setup (int32 line, CONST char **iptr)
+{
+char gbuf[CBUFSIZE], name[CBUFSIZE];
+int32 usecs;
+size_t size;
+void *addr;
+t_stat stat = SCPE_OK;
+CONST char *cptr = *iptr;
+const char *tptr;
+REMOTE *rem = &sim_rem_consoles[line];
+
+sim_debug (DBG_PUB, &sim_remote_console, "Publish Setup: %s\n", cptr);
+if (*cptr == 0)         /* required argument? */
+    return SCPE_2FARG;
+cptr = get_glyph_nc (cptr, name, 0);            /* get segment name */
+get_glyph (name, gbuf, 0);
+if ((strcmp (gbuf, "STOP") == 0) && (*cptr == 0)) {
+    sim_cancel (&rem_con_publish_units[rem->line]);
+    sim_shmem_close (rem->pub_shmem);
+    rem->pub_shmem = NULL;
+    rem->pub_block = NULL;
+    free (rem->pub_regs);
+    rem->pub_regs = NULL;
+    rem->pub_reg_count = 0;
+    rem->pub_interval = 0;
+    free (rem->pub_name);
+    rem->pub_name = NULL;
+    *iptr = cptr;
+    return SCPE_OK;
+    }
+cptr = get_glyph (cptr, gbuf, 0);               /* get next glyph */
+if (MATCH_CMD (gbuf, "EVERY") != 0) {
+    *iptr = cptr;
+    return sim_messagef (SCPE_ARG, "Expected EVERY found: %s\n", gbuf);
+    }
+cptr = get_glyph (cptr, gbuf, 0);               /* get next glyph */
+usecs = (int32) get_uint (gbuf, 10, INT_MAX, &stat);
+if ((stat != SCPE_OK) || (usecs <= 0)) {        /* error? */
+    *iptr = cptr;
+    return sim_messagef (SCPE_ARG, "Expected value found: %s\n", gbuf);
+    }
+cptr = get_glyph (cptr, gbuf, 0);               /* get next glyph */
+if ((MATCH_CMD (gbuf, "USECS") != 0) || (*cptr == 0)) {
+    *iptr = cptr;
+    return sim_messagef (SCPE_ARG, "Expected USECS found: %s\n", gbuf);
+    }
+tptr = strcpy (gbuf, "STOP");                   /* Start from a clean slate */
+sim_rem_publish_cmd_setup (rem->line, &tptr);
+while (cptr && *cptr) {
+    const char *comma = strchr (cptr, ',');
+    char tbuf[2*CBUFSIZE];
+    REG *reg;
+    uint32 idx, last;
+    int32 saved_switches = sim_switches;
+    t_bool indirect = FALSE;
+    PUBLISH_REG *pub_regs;
+
+    if (comma) {
+        strncpy (tbuf, cptr, comma - cptr);
+        tbuf[comma - cptr] = '\0';
+        cptr = comma + 1;
+        }
+    else {
+        strcpy (tbuf, cptr);
+        cptr += strlen (cptr);
+        }
+    tptr = tbuf;
+    if (strchr (tbuf, ' ')) {
+        sim_switches = 0;
+        tptr = get_sim_opt (CMD_OPT_SW|CMD_OPT_DFT, tbuf, &stat); /* get switches and device */
+        indirect = ((sim_switches & SWMASK('I')) != 0);
+        sim_switches = saved_switches;
+        }
+    if (stat != SCPE_OK)
+        break;
+    tptr = get_glyph (tptr, gbuf, 0);           /* get next glyph */
+    reg = find_reg (gbuf, &tptr, sim_dfdev);
+    if (reg == NULL) {
+        stat = sim_messagef (SCPE_NXREG, "Nonexistent Register: %s\n", gbuf);
+        break;
+        }
+    if (*tptr == '[') {                         /* subscript? */
+        const char *tgptr = ++tptr;
+
+        if (reg->depth <= 1) {                  /* array register? */
+            stat = sim_messagef (SCPE_SUB, "Not Array Register: %s\n", reg->name);
+            break;
+            }
+        idx = (uint32) strtotv (tgptr, &tptr, 10);  /* convert index */
+        last = idx;
+        if ((tgptr != tptr) && (*tptr == ':')) {    /* subscript range? */
+            tgptr = ++tptr;
+            last = (uint32) strtotv (tgptr, &tptr, 10);
+            }
+        if ((tgptr == tptr) || (*tptr++ != ']')) {
+            stat = sim_messagef (SCPE_SUB, "Missing or Invalid Register Subscript: %s[%s\n", reg->name, tgptr);
+            break;
+            }
+        if ((last < idx) || (last >= reg->depth)) { /* validate subscript */
+            stat = sim_messagef (SCPE_SUB, "Invalid Register Subscript: %s[%d]\n", reg->name, last);
+            break;
+            }
+        }
+    else
+        idx = last = 0;                         /* not array */
+    pub_regs = (PUBLISH_REG *)realloc (rem->pub_regs, (rem->pub_reg_count + (last - idx) + 1) * sizeof(*pub_regs));
+    if (pub_regs == NULL) {
+        stat = SCPE_MEM;
+        break;
+        }
+    rem->pub_regs = pub_regs;
+    for (; idx <= last; idx++) {
+        pub_regs[rem->pub_reg_count].reg = reg;
+        pub_regs[rem->pub_reg_count].idx = idx;
+        pub_regs[rem->pub_reg_count].dptr = sim_dfdev;
+        pub_regs[rem->pub_reg_count].uptr = sim_dfunit;
+        pub_regs[rem->pub_reg_count].indirect = indirect;
+        rem->pub_reg_count += 1;
+        }
+    }
+if ((stat == SCPE_OK) && (rem->pub_reg_count == 0))
+    stat = SCPE_2FARG;
+if (stat == SCPE_OK) {
+    size = sizeof (*rem->pub_block) + (rem->pub_reg_count - 1) * sizeof (rem->pub_block->values[0]);
+    stat = sim_shmem_open (name, size, &rem->pub_shmem, &addr);
+    }
+if (stat == SCPE_OK) {
+    rem->pub_block = (PUBLISH_BLOCK *)addr;
+    rem->pub_block->magic = PUBLISH_MAGIC;
+    rem->pub_block->version = PUBLISH_VERSION;
+    rem->pub_block->reg_count = rem->pub_reg_count;
+    rem->pub_block->sequence = 0;
+    rem->pub_name = (char *)malloc (1 + strlen (name));
+    if (rem->pub_name == NULL)
+        stat = SCPE_MEM;
+    else
+        strcpy (rem->pub_name, name);
+    }
+if (stat != SCPE_OK) {                          /* Error? */
+    *iptr = cptr;
+    cptr = strcpy (gbuf, "STOP");
+    sim_rem_publish_cmd_setup (line, &cptr);    /* Cleanup mess */
+    return stat;
+    }
+rem->pub_interval = usecs;
+sim_rem_publish_registers (rem);                /* make initial values available */
+sim_activate_after (&rem_con_publish_units[rem->line], rem->pub_interval);
+*iptr = cptr;
+return stat;
+}
+
+t_stat sim_rem_con_publish_svc (UNIT *uptr)
+{
+size_t line = uptr - rem_con_publish_units;
+REMOTE *rem = &sim_rem_consoles[line];
+
+sim_debug (DBG_PUB, &sim_remote_console, "sim_rem_con_publish_svc(line=%" SIZE_T_FMT "u) - interval=%d usecs\n", line, rem->pub_interval);
+if (rem->pub_interval && (rem->pub_block != NULL)) {
+    sim_rem_publish_registers (rem);
+    sim_activate_after (uptr, rem->pub_interval);       /* reschedule */
+    }
+return SCPE_OK;
+}
+
 /* Unit service for remote console data polling */
 
 t_stat sim_rem_con_data_svc (UNIT *uptr)
@@ -1412,6 +1652,10 @@ for (i=(was_active_command ? sim_rem_cmd_active_line : 0);
             cptr = strcpy (gbuf, "STOP");
             sim_rem_collect_cmd_setup (i, &cptr);   /* make sure it is now disabled */
             }
+        if (rem->pub_reg_count) {                   /* were registers being published? */
+            cptr = strcpy (gbuf, "STOP");
+            sim_rem_publish_cmd_setup (i, &cptr);   /* make sure it is now disabled */
+            }
         continue;
         }
     if (master_session && !sim_rem_master_was_connected) {
@@ -1774,20 +2018,26 @@ for (i=(was_active_command ? sim_rem_cmd_active_line : 0);
                                             stat = sim_rem_collect_cmd_setup (i, &cptr);
                                             }
                                         else {
-                                            if ((sim_con_stable_registers &&    /* can we process command now? */
-                                                 sim_rem_master_mode) ||
-                                                (cmdp->action == &x_help_cmd)) {
-                                                sim_debug (DBG_CMD, &sim_remote_console, "Processing Command directly\n");
-                                                sim_oline = lp;         /* specify output socket */
-                                                if (cmdp->action == &x_help_cmd)
-                                                    x_help_cmd (0, cptr);
-                                                else
-                                                    sim_remote_process_command ();
-                                                stat = SCPE_OK;         /* any message has already been emitted */
+                                            if (cmdp->action == &x_publish_cmd) {
+                                                sim_debug (DBG_CMD, &sim_remote_console, "publish_cmd executing\n");
+                                                stat = sim_rem_publish_cmd_setup (i, &cptr);
                                                 }
                                             else {
-                                                sim_debug (DBG_CMD, &sim_remote_console, "Processing Command via SCPE_REMOTE\n");
-                                                stat = SCPE_REMOTE;     /* force processing outside of sim_instr() */
+                                                if ((sim_con_stable_registers &&    /* can we process command now? */
+                                                     sim_rem_master_mode) ||
+                                                    (cmdp->action == &x_help_cmd)) {
+                                                    sim_debug (DBG_CMD, &sim_remote_console, "Processing Command directly\n");
+                                                    sim_oline = lp;         /* specify output socket */
+                                                    if (cmdp->action == &x_help_cmd)
+                                                        x_help_cmd (0, cptr);
+                                                    else
+                                                        sim_remote_process_command ();
+                                                    stat = SCPE_OK;         /* any message has already been emitted */
+                                                    }
+                                                else {
+                                                    sim_debug (DBG_CMD, &sim_remote_console, "Processing Command via SCPE_REMOTE\n");
+                                                    stat = SCPE_REMOTE;     /* force processing outside of sim_instr() */
+                                                    }
                                                 }
                                             }
                                         }
@@ -1906,6 +2156,8 @@ if (sim_rem_con_tmxr.lines) {
             sim_activate_after (&rem_con_repeat_units[rem->line], rem->repeat_interval);    /* schedule */
         if (rem->smp_reg_count)
             sim_activate (&rem_con_smp_smpl_units[rem->line], rem->smp_sample_interval);    /* schedule */
+        if (rem->pub_reg_count)
+            sim_activate_after (&rem_con_publish_units[rem->line], rem->pub_interval);      /* schedule */
         }
     sim_activate_after (rem_con_data_unit, 100000);         /* continue polling for open sessions */
     return sim_rem_con_poll_svc (rem_con_poll_unit);        /* establish polling for new sessions */
@@ -1985,13 +2237,14 @@ for (i=0; i<sim_rem_con_tmxr.lines; i++) {
     free (rem->repeat_action);
     sim_cancel (&rem_con_repeat_units[i]);
     sim_cancel (&rem_con_smp_smpl_units[i]);
+    sim_cancel (&rem_con_publish_units[i]);
     }
 sim_rem_con_tmxr.lines = lines;
 sim_rem_con_tmxr.ldsc = (TMLN *)realloc (sim_rem_con_tmxr.ldsc, sizeof(*sim_rem_con_tmxr.ldsc)*lines);
 memset (sim_rem_con_tmxr.ldsc, 0, sizeof(*sim_rem_con_tmxr.ldsc)*lines);
-sim_remote_console.units = (UNIT *)realloc (sim_remote_console.units, sizeof(*sim_remote_console.units)*((2 * lines) + REM_CON_BASE_UNITS));
-memset (sim_remote_console.units, 0, sizeof(*sim_remote_console.units)*((2 * lines) + REM_CON_BASE_UNITS));
-sim_remote_console.numunits = (2 * lines) + REM_CON_BASE_UNITS;
+sim_remote_console.units = (UNIT *)realloc (sim_remote_console.units, sizeof(*sim_remote_console.units)*((REM_CON_LINE_UNITS * lines) + REM_CON_BASE_UNITS));
+memset (sim_remote_console.units, 0, sizeof(*sim_remote_console.units)*((REM_CON_LINE_UNITS * lines) + REM_CON_BASE_UNITS));
+sim_remote_console.numunits = (REM_CON_LINE_UNITS * lines) + REM_CON_BASE_UNITS;
 rem_con_poll_unit->action = &sim_rem_con_poll_svc;/* remote console connection polling unit */
 rem_con_poll_unit->flags |= UNIT_IDLE;
 rem_con_data_unit->action = &sim_rem_con_data_svc;/* console data handling unit */
@@ -2005,6 +2258,8 @@ for (i=0; i<lines; i++) {
     rem_con_repeat_units[i].action = &sim_rem_con_repeat_svc;
     rem_con_smp_smpl_units[i].flags = UNIT_DIS;
     rem_con_smp_smpl_units[i].action = &sim_rem_con_smp_collect_svc;
+    rem_con_publish_units[i].flags = UNIT_DIS;
+    rem_con_publish_units[i].action = &sim_rem_con_publish_svc;
     rem = &sim_rem_consoles[i];
     rem->line = i;
     rem->lp = &sim_rem_con_tmxr.ldsc[i];
@@ -617,6 +617,7 @@ struct UNIT {
     char                *uname;                         /* Unit name */
     DEVICE              *dptr;                          /* DEVICE linkage (backpointer) */
     uint32              dctrl;                          /* debug control */
+    t_uint64            event_count;                    /* events processed */
 #ifdef SIM_ASYNCH_IO
     void                (*a_check_completion)(UNIT *);
     t_bool              (*a_is_active)(UNIT *);
@@ -819,6 +820,13 @@ struct BRKTAB {
     BRKTAB *next;                                       /* list with same address value */
     };
 
+/* Watch page map geometry: the types of all breakpoints within a page of
+   2**SIM_BRK_V_PAGE addresses are summarized in one map entry */
+
+#define SIM_BRK_V_PAGE          9                       /* log2 addresses per page */
+#define SIM_BRK_N_PAGE          12                      /* log2 map entries */
+#define SIM_BRK_PAGE(a)         ((uint32)((a) >> SIM_BRK_V_PAGE) & ((1u << SIM_BRK_N_PAGE) - 1))
+
 /* Breakpoint table */
 
 struct BRKTYPTAB {
@@ -844,6 +852,7 @@ struct EXPTAB {
 #if defined(USE_REGEX)
     pcre                *regex;                         /* compiled regular expression */
     int                 re_nsub;                        /* regular expression sub expression count */
+    size_t              re_start;                       /* earliest buffer offset a match could still start at */
 #endif
     char                *act;                           /* action string */
     };
@@ -859,6 +868,11 @@ struct EXPECT {
     size_t              buf_ins;                        /* buffer insertion point for the next output data */
     size_t              buf_size;                       /* buffer size */
     size_t              buf_data;                       /* count of data in buffer */
+    uint32              *ac_goto;                       /* string rule matcher transitions (256 per state) */
+    int32               *ac_rule;                       /* first string rule matched in each matcher state */
+    uint32              ac_state;                       /* current string rule matcher state */
+    t_bool              ac_dirty;                       /* rules changed since matcher was built */
+    size_t              regex_count;                    /* count of regular expression rules */
     };
 
 /* Send Context */
@@ -52,6 +52,7 @@ Public routines:
    sim_disk_show_capac       show disk capacity
    sim_disk_set_async        enable asynchronous operation
    sim_disk_clr_async        disable asynchronous operation
+   sim_disk_show_ioq         show asynchronous queue depth and latency
    sim_disk_data_trace       debug support
    sim_disk_test             unit test routine
 
@@ -149,6 +150,25 @@ return value;
 }
 #endif
 
+#if defined SIM_ASYNCH_IO
+#define DISK_HIST_DEPTH     8                   /* queue depth buckets 1 .. 7, 8+ */
+#define DISK_HIST_LATENCY   12                  /* latency buckets <64us, <128us, ... */
+#define DISK_HIST_LAT_BASE  64                  /* upper bound of first latency bucket (usecs) */
+#define DISK_POOL_WORKERS   4                   /* I/O worker threads */
+
+struct disk_request {
+    struct disk_request *next;
+    int                 dop;                /* operation */
+    t_lba               lba;
+    uint8               *buf;
+    t_seccnt            *rsects;
+    t_seccnt            sects;
+    DISK_PCALLBACK      callback;
+    t_stat              io_status;
+    double              queue_time;         /* when request was queued */
+    };
+#endif
+
 struct disk_context {
     t_offset            container_size;     /* Size of the data portion (of the pseudo disk) */
     t_offset            highwater;          /* Furthest written sector in the disk */
@@ -173,19 +193,16 @@ struct disk_context {
 #if defined SIM_ASYNCH_IO
     int                 asynch_io;          /* Asynchronous Interrupt scheduling enabled */
     int                 asynch_io_latency;  /* instructions to delay pending interrupt */
-    pthread_mutex_t     lock;
-    pthread_t           io_thread;          /* I/O Thread Id */
-    pthread_mutex_t     io_lock;
-    pthread_cond_t      io_cond;
-    pthread_cond_t      io_done;
-    pthread_cond_t      startup_cond;
-    int                 io_dop;
-    uint8               *buf;
-    t_seccnt            *rsects;
-    t_seccnt            sects;
-    t_lba               lba;
-    DISK_PCALLBACK      callback;
-    t_stat              io_status;
+    struct disk_request *pending;           /* queued requests (FIFO) */
+    struct disk_request *pending_tail;
+    uint32              pending_count;      /* number of queued requests */
+    struct disk_request *done;              /* completed requests awaiting callback */
+    struct disk_request *done_tail;
+    t_bool              busy;               /* a worker is performing a request */
+    t_bool              ready;              /* unit is on the worker pool ready list */
+    UNIT                *ready_next;        /* next unit on the ready list */
+    uint32              depth_hist[DISK_HIST_DEPTH];    /* requests by queue depth at submission */
+    uint32              latency_hist[DISK_HIST_LATENCY];/* requests by queue+service time */
 #endif
     };
 
@@ -198,27 +215,8 @@ struct disk_context *ctx = (struct disk_context *)uptr->disk_ctx;   \
 if ((!callback) || !ctx->asynch_io)
 
 #define AIO_CALL(op, _lba, _buf, _rsects, _sects,  _callback)   \
-    if (ctx->asynch_io) {                                       \
-        struct disk_context *ctx =                              \
-                      (struct disk_context *)uptr->disk_ctx;    \
-                                                                \
-        pthread_mutex_lock (&ctx->io_lock);                     \
-                                                                \
-        sim_debug_unit (ctx->dbit, uptr,                        \
-      "sim_disk AIO_CALL(op=%d, unit=%d, lba=0x%X, sects=%d)\n",\
-                op, (int)(uptr - ctx->dptr->units), _lba, _sects);\
-                                                                \
-        if (ctx->callback)                                      \
-            abort(); /* horrible mistake, stop */               \
-        ctx->io_dop = op;                                       \
-        ctx->lba = _lba;                                        \
-        ctx->buf = _buf;                                        \
-        ctx->sects = _sects;                                    \
-        ctx->rsects = _rsects;                                  \
-        ctx->callback = _callback;                              \
-        pthread_cond_signal (&ctx->io_cond);                    \
-        pthread_mutex_unlock (&ctx->io_lock);                   \
-        }                                                       \
+    if (ctx->asynch_io)                                         \
+        _disk_queue_request (uptr, op, _lba, _buf, _rsects, _sects, _callback);\
     else                                                        \
         if (_callback)                                          \
             (_callback) (uptr, r);
@@ -229,47 +227,144 @@ if ((!callback) || !ctx->asynch_io)
 #define DOP_WSEC  2             /* sim_disk_wrsect_a */
 #define DOP_IAVL  3             /* sim_disk_isavailable_a */
 
-static void *
-_disk_io(void *arg)
+/* Asynchronous requests for all units are performed by a shared pool of
+   worker threads rather than by a thread per unit.  Each unit has a FIFO
+   of queued requests and a list of completed requests whose callbacks
+   have not yet been invoked.  A unit with queued requests sits on the
+   pool's ready list until a worker takes one request from it; the unit
+   goes back on the end of the ready list if more requests remain.  A
+   unit's requests are therefore performed one at a time and in order
+   (the container formats position and then read or write the underlying
+   stream), while requests for different units proceed in parallel. */
+
+static struct {
+    pthread_mutex_t     lock;               /* protects pool and all unit queues */
+    pthread_cond_t      work;               /* ready list is not empty */
+    pthread_cond_t      idle;               /* some unit's queue drained */
+    pthread_t           workers[DISK_POOL_WORKERS];
+    int                 worker_count;
+    UNIT                *ready;             /* units with queued requests */
+    UNIT                *ready_tail;
+    } disk_pool = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER};
+
+/* Put a unit on the end of the ready list (pool lock held) */
+
+static void _disk_pool_ready (UNIT *uptr)
 {
-UNIT* volatile uptr = (UNIT*)arg;
 struct disk_context *ctx = (struct disk_context *)uptr->disk_ctx;
 
+ctx->ready = TRUE;
+ctx->ready_next = NULL;
+if (disk_pool.ready_tail)
+    ((struct disk_context *)disk_pool.ready_tail->disk_ctx)->ready_next = uptr;
+else
+    disk_pool.ready = uptr;
+disk_pool.ready_tail = uptr;
+pthread_cond_signal (&disk_pool.work);
+}
+
+static void *
+_disk_io(void *arg)
+{
 /* Boost Priority for this I/O thread vs the CPU instruction execution
    thread which in general won't be readily yielding the processor when
    this thread needs to run */
 sim_os_set_thread_priority (PRIORITY_ABOVE_NORMAL);
 
-sim_debug_unit (ctx->dbit, uptr, "_disk_io(unit=%d) starting\n", (int)(uptr - ctx->dptr->units));
-
-pthread_mutex_lock (&ctx->io_lock);
-pthread_cond_signal (&ctx->startup_cond);   /* Signal we're ready to go */
-while (ctx->asynch_io) {
-    pthread_cond_wait (&ctx->io_cond, &ctx->io_lock);
-    if (ctx->io_dop == DOP_DONE)
-        break;
-    pthread_mutex_unlock (&ctx->io_lock);
-    switch (ctx->io_dop) {
+pthread_mutex_lock (&disk_pool.lock);
+while (1) {
+    UNIT *uptr;
+    struct disk_context *ctx;
+    struct disk_request *req;
+    double usecs;
+    int bucket;
+
+    while (disk_pool.ready == NULL)
+        pthread_cond_wait (&disk_pool.work, &disk_pool.lock);
+    uptr = disk_pool.ready;                             /* take the next ready unit */
+    ctx = (struct disk_context *)uptr->disk_ctx;
+    disk_pool.ready = ctx->ready_next;
+    if (disk_pool.ready == NULL)
+        disk_pool.ready_tail = NULL;
+    ctx->ready = FALSE;
+    req = ctx->pending;                                 /* and its oldest request */
+    ctx->pending = req->next;
+    if (ctx->pending == NULL)
+        ctx->pending_tail = NULL;
+    --ctx->pending_count;
+    ctx->busy = TRUE;
+    pthread_mutex_unlock (&disk_pool.lock);
+    sim_debug_unit (ctx->dbit, uptr, "_disk_io(unit=%d, dop=%d, lba=0x%X, sects=%d)\n", (int)(uptr - ctx->dptr->units), req->dop, req->lba, req->sects);
+    switch (req->dop) {
         case DOP_RSEC:
-            ctx->io_status = sim_disk_rdsect (uptr, ctx->lba, ctx->buf, ctx->rsects, ctx->sects);
+            req->io_status = sim_disk_rdsect (uptr, req->lba, req->buf, req->rsects, req->sects);
             break;
         case DOP_WSEC:
-            ctx->io_status = sim_disk_wrsect (uptr, ctx->lba, ctx->buf, ctx->rsects, ctx->sects);
+            req->io_status = sim_disk_wrsect (uptr, req->lba, req->buf, req->rsects, req->sects);
             break;
         case DOP_IAVL:
-            ctx->io_status = sim_disk_isavailable (uptr);
+            req->io_status = sim_disk_isavailable (uptr);
             break;
         }
-    pthread_mutex_lock (&ctx->io_lock);
-    ctx->io_dop = DOP_DONE;
-    pthread_cond_signal (&ctx->io_done);
+    usecs = (sim_timenow_double () - req->queue_time) * 1000000.0;
+    for (bucket = 0; (bucket < DISK_HIST_LATENCY - 1) && (usecs >= (double)(DISK_HIST_LAT_BASE << bucket)); bucket++)
+        ;
+    pthread_mutex_lock (&disk_pool.lock);
+    ++ctx->latency_hist[bucket];
+    req->next = NULL;                                   /* append to completed list */
+    if (ctx->done_tail)
+        ctx->done_tail->next = req;
+    else
+        ctx->done = req;
+    ctx->done_tail = req;
+    /* Wake the unit while ctx is still ours; once busy is clear and idle
+       is signalled, sim_disk_clr_async may return and detach free ctx */
     sim_activate (uptr, ctx->asynch_io_latency);
+    ctx->busy = FALSE;
+    if (ctx->pending)                                   /* more to do for this unit? */
+        _disk_pool_ready (uptr);
+    else
+        pthread_cond_broadcast (&disk_pool.idle);
     }
-pthread_mutex_unlock (&ctx->io_lock);
+return NULL;
+}
 
-sim_debug_unit (ctx->dbit, uptr, "_disk_io(unit=%d) exiting\n", (int)(uptr - ctx->dptr->units));
+/* Queue an asynchronous request for a unit */
 
-return NULL;
+static void _disk_queue_request (UNIT *uptr, int dop, t_lba lba, uint8 *buf, t_seccnt *rsects, t_seccnt sects, DISK_PCALLBACK callback)
+{
+struct disk_context *ctx = (struct disk_context *)uptr->disk_ctx;
+struct disk_request *req = (struct disk_request *)calloc (1, sizeof (*req));
+uint32 depth;
+
+sim_debug_unit (ctx->dbit, uptr, "sim_disk AIO_CALL(op=%d, unit=%d, lba=0x%X, sects=%d)\n", dop, (int)(uptr - ctx->dptr->units), lba, sects);
+if (req == NULL) {                                      /* can't queue? do it now */
+    t_stat r = (dop == DOP_RSEC) ? sim_disk_rdsect (uptr, lba, buf, rsects, sects) :
+               (dop == DOP_WSEC) ? sim_disk_wrsect (uptr, lba, buf, rsects, sects) :
+                                   sim_disk_isavailable (uptr);
+    if (callback)
+        callback (uptr, r);
+    return;
+    }
+req->dop = dop;
+req->lba = lba;
+req->buf = buf;
+req->rsects = rsects;
+req->sects = sects;
+req->callback = callback;
+req->queue_time = sim_timenow_double ();
+pthread_mutex_lock (&disk_pool.lock);
+depth = ctx->pending_count + (ctx->busy ? 1 : 0) + 1;   /* outstanding including this one */
+++ctx->depth_hist[(depth < DISK_HIST_DEPTH) ? depth - 1 : DISK_HIST_DEPTH - 1];
+if (ctx->pending_tail)
+    ctx->pending_tail->next = req;
+else
+    ctx->pending = req;
+ctx->pending_tail = req;
+++ctx->pending_count;
+if ((!ctx->busy) && (!ctx->ready))
+    _disk_pool_ready (uptr);
+pthread_mutex_unlock (&disk_pool.lock);
 }
 
 /* This routine is called in the context of the main simulator thread before
@@ -278,34 +373,41 @@ return NULL;
    routine is to put the unit in proper condition to digest what may have
    occurred in the asynchronous thread.
 
-   Since disk processing only handles a single I/O at a time to a
-   particular disk device (due to using stdio for the SimH Disk format
-   and stdio doesn't have an atomic seek+(read|write) operation),
-   we have the opportunity to possibly detect improper attempts to
-   issue multiple concurrent I/O requests. */
+   All requests which have completed since the last call have their
+   callbacks invoked, in the order the requests were queued. */
 static void _disk_completion_dispatch (UNIT *uptr)
 {
 struct disk_context *ctx = (struct disk_context *)uptr->disk_ctx;
-DISK_PCALLBACK callback = ctx->callback;
+struct disk_request *req;
 
-sim_debug_unit (ctx->dbit, uptr, "_disk_completion_dispatch(unit=%d, dop=%d, callback=%p)\n", (int)(uptr - ctx->dptr->units), ctx->io_dop, (void *)(ctx->callback));
-
-if (ctx->io_dop != DOP_DONE)
-    abort();                                            /* horribly wrong, stop */
+if (ctx == NULL)                                        /* detached meanwhile? */
+    return;
+pthread_mutex_lock (&disk_pool.lock);
+req = ctx->done;
+ctx->done = ctx->done_tail = NULL;
+pthread_mutex_unlock (&disk_pool.lock);
+while (req) {
+    struct disk_request *next = req->next;
 
-if (ctx->callback && ctx->io_dop == DOP_DONE) {
-    ctx->callback = NULL;
-    callback (uptr, ctx->io_status);
+    sim_debug_unit (ctx->dbit, uptr, "_disk_completion_dispatch(unit=%d, dop=%d, callback=%p)\n", (int)(uptr - ctx->dptr->units), req->dop, (void *)(req->callback));
+    if (req->callback)
+        req->callback (uptr, req->io_status);
+    free (req);
+    req = next;
     }
 }
 
 static t_bool _disk_is_active (UNIT *uptr)
 {
 struct disk_context *ctx = (struct disk_context *)uptr->disk_ctx;
+t_bool active;
 
 if (ctx) {
-    sim_debug_unit (ctx->dbit, uptr, "_disk_is_active(unit=%d, dop=%d)\n", (int)(uptr - ctx->dptr->units), ctx->io_dop);
-    return (ctx->io_dop != DOP_DONE);
+    pthread_mutex_lock (&disk_pool.lock);
+    active = ((ctx->pending != NULL) || ctx->busy);
+    pthread_mutex_unlock (&disk_pool.lock);
+    sim_debug_unit (ctx->dbit, uptr, "_disk_is_active(unit=%d, active=%d)\n", (int)(uptr - ctx->dptr->units), active);
+    return active;
     }
 return FALSE;
 }
@@ -315,12 +417,12 @@ static t_bool _disk_cancel (UNIT *uptr)
 struct disk_context *ctx = (struct disk_context *)uptr->disk_ctx;
 
 if (ctx) {
-    sim_debug_unit (ctx->dbit, uptr, "_disk_cancel(unit=%d, dop=%d)\n", (int)(uptr - ctx->dptr->units), ctx->io_dop);
-    if (ctx->asynch_io) {
-        pthread_mutex_lock (&ctx->io_lock);
-        while (ctx->io_dop != DOP_DONE)
-            pthread_cond_wait (&ctx->io_done, &ctx->io_lock);
-        pthread_mutex_unlock (&ctx->io_lock);
+    sim_debug_unit (ctx->dbit, uptr, "_disk_cancel(unit=%d, pending=%u)\n", (int)(uptr - ctx->dptr->units), ctx->pending_count);
+    if (ctx->asynch_io) {                               /* wait for queued requests to finish */
+        pthread_mutex_lock (&disk_pool.lock);
+        while ((ctx->pending != NULL) || ctx->busy)
+            pthread_cond_wait (&disk_pool.idle, &disk_pool.lock);
+        pthread_mutex_unlock (&disk_pool.lock);
         }
     }
 return FALSE;
@@ -591,18 +693,20 @@ sim_debug_unit (ctx->dbit, uptr, "sim_disk_set_async(unit=%d)\n", (int)(uptr - c
 ctx->asynch_io = sim_asynch_enabled;
 ctx->asynch_io_latency = latency;
 if (ctx->asynch_io) {
-    pthread_mutex_init (&ctx->io_lock, NULL);
-    pthread_cond_init (&ctx->io_cond, NULL);
-    pthread_cond_init (&ctx->io_done, NULL);
-    pthread_cond_init (&ctx->startup_cond, NULL);
-    pthread_attr_init(&attr);
-    pthread_attr_setscope(&attr, PTHREAD_SCOPE_SYSTEM);
-    pthread_mutex_lock (&ctx->io_lock);
-    pthread_create (&ctx->io_thread, &attr, _disk_io, (void *)uptr);
-    pthread_attr_destroy(&attr);
-    pthread_cond_wait (&ctx->startup_cond, &ctx->io_lock); /* Wait for thread to stabilize */
-    pthread_mutex_unlock (&ctx->io_lock);
-    pthread_cond_destroy (&ctx->startup_cond);
+    pthread_mutex_lock (&disk_pool.lock);
+    if (disk_pool.worker_count == 0) {                  /* first use? start the worker pool */
+        pthread_attr_init(&attr);
+        pthread_attr_setscope(&attr, PTHREAD_SCOPE_SYSTEM);
+        while (disk_pool.worker_count < DISK_POOL_WORKERS) {
+            if (pthread_create (&disk_pool.workers[disk_pool.worker_count], &attr, _disk_io, NULL))
+                break;
+            ++disk_pool.worker_count;
+            }
+        pthread_attr_destroy(&attr);
+        }
+    pthread_mutex_unlock (&disk_pool.lock);
+    if (disk_pool.worker_count == 0)                    /* no workers? */
+        ctx->asynch_io = 0;                             /* then synchronous */
     }
 uptr->a_check_completion = _disk_completion_dispatch;
 uptr->a_is_active = _disk_is_active;
@@ -611,6 +715,44 @@ return SCPE_OK;
 #endif
 }
 
+/* Show asynchronous I/O queue statistics */
+
+t_stat sim_disk_show_ioq (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
+{
+#if !defined(SIM_ASYNCH_IO)
+fprintf (st, "synchronous I/O");
+return SCPE_OK;
+#else
+struct disk_context *ctx = (struct disk_context *)uptr->disk_ctx;
+uint32 depth[DISK_HIST_DEPTH], latency[DISK_HIST_LATENCY], pending;
+t_bool busy;
+int i;
+
+if ((ctx == NULL) || (!ctx->asynch_io)) {
+    fprintf (st, "synchronous I/O");
+    return SCPE_OK;
+    }
+pthread_mutex_lock (&disk_pool.lock);
+memcpy (depth, ctx->depth_hist, sizeof (depth));
+memcpy (latency, ctx->latency_hist, sizeof (latency));
+pending = ctx->pending_count;
+busy = ctx->busy;
+pthread_mutex_unlock (&disk_pool.lock);
+fprintf (st, "asynchronous I/O, %u queued%s\n", pending, busy ? ", 1 in progress" : "");
+fprintf (st, "  queue depth:");
+for (i = 0; i < DISK_HIST_DEPTH; i++)
+    fprintf (st, " %d%s:%u", i + 1, (i == DISK_HIST_DEPTH - 1) ? "+" : "", depth[i]);
+fprintf (st, "\n  latency:    ");
+for (i = 0; i < DISK_HIST_LATENCY; i++) {
+    if (i < DISK_HIST_LATENCY - 1)
+        fprintf (st, " <%s:%u", sim_fmt_secs ((DISK_HIST_LAT_BASE << i) / 1000000.0), latency[i]);
+    else
+        fprintf (st, " >=%s:%u", sim_fmt_secs ((DISK_HIST_LAT_BASE << (i - 1)) / 1000000.0), latency[i]);
+    }
+return SCPE_OK;
+#endif
+}
+
 /* Disable asynchronous operation */
 
 t_stat sim_disk_clr_async (UNIT *uptr)
@@ -626,14 +768,8 @@ if (!ctx) return SCPE_UNATT;
 sim_debug_unit (ctx->dbit, uptr, "sim_disk_clr_async(unit=%d)\n", (int)(uptr - ctx->dptr->units));
 
 if (ctx->asynch_io) {
-    pthread_mutex_lock (&ctx->io_lock);
+    _disk_cancel (uptr);                                /* let queued requests finish */
     ctx->asynch_io = 0;
-    pthread_cond_signal (&ctx->io_cond);
-    pthread_mutex_unlock (&ctx->io_lock);
-    pthread_join (ctx->io_thread, NULL);
-    pthread_mutex_destroy (&ctx->io_lock);
-    pthread_cond_destroy (&ctx->io_cond);
-    pthread_cond_destroy (&ctx->io_done);
     }
 return SCPE_OK;
 #endif
@@ -3401,6 +3537,14 @@ if (uptr->io_flush)
     uptr->io_flush (uptr);                              /* flush buffered data */
 
 sim_disk_clr_async (uptr);
+#if defined (SIM_ASYNCH_IO)
+while (ctx->done) {                                     /* discard undelivered completions */
+    struct disk_request *next = ctx->done->next;
+
+    free (ctx->done);
+    ctx->done = next;
+    }
+#endif
 
 uptr->flags &= ~(UNIT_ATT | UNIT_RO);
 uptr->dynflags &= ~(UNIT_NO_FIO | UNIT_DISK_CHK);
@@ -3540,6 +3684,9 @@ fprintf (st, "    -M          Merge a Differencing VHD into its parent VHD disk\
 fprintf (st, "    -O          Override consistency checks when attaching differencing disks\n");
 fprintf (st, "                which have unexpected parent disk GUID or timestamps\n\n");
 fprintf (st, "    -U          Fix inconsistencies which are overridden by the -O switch\n");
+fprintf (st, "    -S          Map read only VHD images (including the parents of a differencing\n");
+fprintf (st, "                VHD) so that simulators using the same base image share one\n");
+fprintf (st, "                copy of it in host memory\n");
 if (strstr (sim_name, "-10") == NULL) {
     fprintf (st, "    -Y          Answer Yes to prompt to overwrite last track (on disk create)\n");
     fprintf (st, "    -N          Answer No to prompt to overwrite last track (on disk create)\n");
@@ -5296,8 +5443,56 @@ struct VHD_IOData {
     FILE *File;
     char ParentVHDPath[512];
     struct VHD_IOData *Parent;
+    uint32 Blocks;                      /* BAT entries */
+    uint32 BitMapBytes;                 /* bytes in each block's sector bitmap */
+    uint32 BitMapSectors;               /* sectors preceding each block's data */
+    uint8 *BlockState;                  /* per block bitmap cache state (VHD_BLOCK_xxx) */
+    uint8 **BitMaps;                    /* cached bitmaps of partially populated blocks */
+    uint8 *Resolved;                    /* per block depth of the parent holding unallocated blocks */
+    uint32 DirtyBitMaps;                /* blocks with bitmaps not yet written back */
+    SHMEM *MapShmem;                    /* shared mapping of a read only base image */
+    uint8 *Map;
+    size_t MapSize;
     };
 
+/* Block bitmap cache states */
+
+#define VHD_BLOCK_UNKNOWN           0   /* bitmap not yet read */
+#define VHD_BLOCK_FULL              1   /* every sector present */
+#define VHD_BLOCK_PARTIAL           2   /* bitmap cached in BitMaps[] */
+#define VHD_BLOCK_DIRTY             3   /* every sector present, bitmap needs write back */
+
+/* Parent chain resolution of unallocated blocks (otherwise the depth of the parent) */
+
+#define VHD_RESOLVE_UNKNOWN         0   /* not yet looked up */
+#define VHD_RESOLVE_WALK         0xFE   /* partially populated somewhere, walk the chain */
+#define VHD_RESOLVE_ZERO         0xFF   /* allocated nowhere, reads as zeros */
+
+#define VHD_BITMAP_TEST(bm, s)      ((bm)[(s) >> 3] & (0x80 >> ((s) & 7)))
+
+/* Read from a VHD file, straight from its shared mapping when it has one */
+static t_stat
+ReadVirtualDiskFile(VHDHANDLE hVHD,
+                    void *buf,
+                    size_t bufsize,
+                    uint32 *bytesread,
+                    uint64 position)
+{
+size_t bytes = 0;
+
+if (hVHD->Map == NULL)
+    return ReadFilePosition(hVHD->File, buf, bufsize, bytesread, position);
+if (position < (uint64)hVHD->MapSize) {
+    bytes = hVHD->MapSize - (size_t)position;
+    if (bytes > bufsize)
+        bytes = bufsize;
+    memcpy (buf, hVHD->Map + position, bytes);
+    }
+if (bytesread)
+    *bytesread = (uint32)bytes;
+return SCPE_OK;
+}
+
 static t_stat sim_vhd_disk_implemented (void)
 {
 return SCPE_OK;
@@ -5375,6 +5570,63 @@ if (creation_time)
 return (char *)(&hVHD->Footer.DriveType[0]);
 }
 
+/*
+   Dynamic and differencing disks keep the BAT in memory.  Block bitmaps
+   are only consulted for differencing disks and are cached once read.
+   Blocks which become fully populated have their bitmaps written back
+   in a batch when the disk is flushed or closed.
+*/
+static int
+InitVirtualDiskCache (VHDHANDLE hVHD)
+{
+if (NtoHl (hVHD->Footer.DiskType) == VHD_DT_Fixed)
+    return 0;
+hVHD->Blocks = NtoHl (hVHD->Dynamic.MaxTableEntries);
+hVHD->BitMapBytes = (7 + (NtoHl (hVHD->Dynamic.BlockSize) / VHD_Internal_SectorSize)) / 8;
+hVHD->BitMapSectors = (hVHD->BitMapBytes + VHD_Internal_SectorSize - 1) / VHD_Internal_SectorSize;
+hVHD->BlockState = (uint8 *)calloc (hVHD->Blocks, sizeof (*hVHD->BlockState));
+if (hVHD->Parent) {
+    hVHD->BitMaps = (uint8 **)calloc (hVHD->Blocks, sizeof (*hVHD->BitMaps));
+    hVHD->Resolved = (uint8 *)calloc (hVHD->Blocks, sizeof (*hVHD->Resolved));
+    if ((hVHD->BitMaps == NULL) || (hVHD->Resolved == NULL))
+        return ENOMEM;
+    }
+if (hVHD->BlockState == NULL)
+    return ENOMEM;
+return 0;
+}
+
+static t_stat
+FlushVirtualDiskBitMaps (VHDHANDLE hVHD)
+{
+uint8 *BitMap;
+uint32 BlockNumber;
+t_stat r = SCPE_OK;
+
+if (hVHD->DirtyBitMaps == 0)
+    return SCPE_OK;
+BitMap = (uint8 *)malloc (hVHD->BitMapBytes);
+if (BitMap == NULL)
+    return SCPE_MEM;
+memset (BitMap, 0xFF, hVHD->BitMapBytes);
+for (BlockNumber = 0; (BlockNumber < hVHD->Blocks) && (hVHD->DirtyBitMaps > 0); ++BlockNumber) {
+    if (hVHD->BlockState[BlockNumber] != VHD_BLOCK_DIRTY)
+        continue;
+    if (WriteFilePosition(hVHD->File,
+                          BitMap,
+                          hVHD->BitMapBytes,
+                          NULL,
+                          VHD_Internal_SectorSize * (uint64)NtoHl (hVHD->BAT[BlockNumber]))) {
+        r = SCPE_IOERR;
+        break;
+        }
+    hVHD->BlockState[BlockNumber] = VHD_BLOCK_FULL;
+    --hVHD->DirtyBitMaps;
+    }
+free (BitMap);
+return r;
+}
+
 static FILE *sim_vhd_disk_open (const char *szVHDPath, const char *DesiredAccess)
     {
     VHDHANDLE hVHD = (VHDHANDLE) calloc (1, sizeof(*hVHD));
@@ -5438,6 +5690,15 @@ static FILE *sim_vhd_disk_open (const char *szVHDPath, const char *DesiredAccess
         Status = errno;
         goto Cleanup_Return;
         }
+    Status = InitVirtualDiskCache (hVHD);
+    if ((Status == 0) &&
+        (sim_switches & SWMASK ('S')) &&                /* Share read only images? */
+        (strchr (DesiredAccess, '+') == NULL)) {
+        void *Map;
+
+        if (sim_shmem_map_file (hVHD->File, FALSE, 0, &hVHD->MapShmem, &Map, &hVHD->MapSize) == SCPE_OK)
+            hVHD->Map = (uint8 *)Map;
+        }
 Cleanup_Return:
     if (Status) {
         sim_vhd_disk_close ((FILE *)hVHD);
@@ -5585,11 +5846,22 @@ VHDHANDLE hVHD = (VHDHANDLE)f;
 if (NULL != hVHD) {
     if (hVHD->Parent)
         sim_vhd_disk_close ((FILE *)hVHD->Parent);
-    free (hVHD->BAT);
+    sim_shmem_close (hVHD->MapShmem);
     if (hVHD->File) {
+        FlushVirtualDiskBitMaps (hVHD);
         fflush (hVHD->File);
         fclose (hVHD->File);
         }
+    if (hVHD->BitMaps) {
+        uint32 BlockNumber;
+
+        for (BlockNumber = 0; BlockNumber < hVHD->Blocks; ++BlockNumber)
+            free (hVHD->BitMaps[BlockNumber]);
+        free (hVHD->BitMaps);
+        }
+    free (hVHD->BlockState);
+    free (hVHD->Resolved);
+    free (hVHD->BAT);
     free (hVHD);
     return 0;
     }
@@ -5600,8 +5872,10 @@ static void sim_vhd_disk_flush (FILE *f)
 {
 VHDHANDLE hVHD = (VHDHANDLE)f;
 
-if ((NULL != hVHD) && (hVHD->File))
+if ((NULL != hVHD) && (hVHD->File)) {
+    FlushVirtualDiskBitMaps (hVHD);
     fflush (hVHD->File);
+    }
 }
 
 static t_offset sim_vhd_disk_size (FILE *f)
@@ -6125,6 +6399,177 @@ static FILE *sim_vhd_disk_create_diff (const char *szVHDPath, const char *szPare
 return (FILE *)CreateDifferencingVirtualDisk (szVHDPath, szParentVHDPath);
 }
 
+static t_stat
+ReadVirtualDisk(VHDHANDLE hVHD,
+                uint8 *buf,
+                uint32 BytesToRead,
+                uint32 *BytesRead,
+                uint64 Offset);
+
+/* Return the (cached) bitmap state of an allocated block */
+static uint8
+GetVirtualDiskBlockState(VHDHANDLE hVHD,
+                         uint32 BlockNumber)
+{
+uint8 *BitMap;
+uint32 BytesRead;
+uint32 i;
+
+if (hVHD->BlockState == NULL)
+    return VHD_BLOCK_UNKNOWN;
+if (hVHD->BlockState[BlockNumber] != VHD_BLOCK_UNKNOWN)
+    return hVHD->BlockState[BlockNumber];
+if (hVHD->BitMaps == NULL)          /* Not differencing? */
+    return hVHD->BlockState[BlockNumber] = VHD_BLOCK_FULL;
+BitMap = (uint8 *)malloc (hVHD->BitMapBytes);
+if (BitMap == NULL)
+    return VHD_BLOCK_UNKNOWN;
+if (ReadVirtualDiskFile(hVHD,
+                        BitMap,
+                        hVHD->BitMapBytes,
+                        &BytesRead,
+                        VHD_Internal_SectorSize * (uint64)NtoHl (hVHD->BAT[BlockNumber])) ||
+    (BytesRead != hVHD->BitMapBytes)) {
+    free (BitMap);
+    return VHD_BLOCK_UNKNOWN;
+    }
+for (i = 0; (i < hVHD->BitMapBytes) && (BitMap[i] == 0xFF); ++i)
+    ;
+if (i == hVHD->BitMapBytes) {
+    free (BitMap);
+    return hVHD->BlockState[BlockNumber] = VHD_BLOCK_FULL;
+    }
+hVHD->BitMaps[BlockNumber] = BitMap;
+return hVHD->BlockState[BlockNumber] = VHD_BLOCK_PARTIAL;
+}
+
+/* Find which level of the parent chain supplies an unallocated block */
+static uint8
+ResolveVirtualDiskBlock(VHDHANDLE hVHD,
+                        uint32 BlockNumber)
+{
+VHDHANDLE hParent;
+uint8 Depth;
+
+if (hVHD->Parent == NULL)
+    return VHD_RESOLVE_ZERO;
+if (hVHD->Resolved[BlockNumber] != VHD_RESOLVE_UNKNOWN)
+    return hVHD->Resolved[BlockNumber];
+for (hParent = hVHD->Parent, Depth = 1; hParent != NULL; hParent = hParent->Parent, ++Depth) {
+    if ((BlockNumber >= hParent->Blocks) ||     /* Fixed or smaller parent? */
+        (Depth == VHD_RESOLVE_WALK))
+        return hVHD->Resolved[BlockNumber] = VHD_RESOLVE_WALK;
+    if (hParent->BAT[BlockNumber] == VHD_BAT_FREE_ENTRY)
+        continue;
+    switch (GetVirtualDiskBlockState (hParent, BlockNumber)) {
+        case VHD_BLOCK_UNKNOWN:                 /* Bitmap unreadable, try again later */
+            return VHD_RESOLVE_WALK;
+        case VHD_BLOCK_PARTIAL:
+            return hVHD->Resolved[BlockNumber] = VHD_RESOLVE_WALK;
+        default:
+            return hVHD->Resolved[BlockNumber] = Depth;
+        }
+    }
+return hVHD->Resolved[BlockNumber] = VHD_RESOLVE_ZERO;
+}
+
+/* Read from a block whose bitmap has sectors still held by the parent */
+static t_stat
+ReadVirtualDiskPartialBlock(VHDHANDLE hVHD,
+                            uint32 BlockNumber,
+                            uint8 *buf,
+                            uint32 BytesToRead,
+                            uint32 *BytesRead,
+                            uint64 Offset)
+{
+uint32 DynamicBlockSize = NtoHl (hVHD->Dynamic.BlockSize);
+uint64 DataOffset = VHD_Internal_SectorSize * ((uint64)(NtoHl (hVHD->BAT[BlockNumber]) + hVHD->BitMapSectors));
+uint8 *BitMap = hVHD->BitMaps[BlockNumber];
+t_stat r = SCPE_OK;
+
+*BytesRead = 0;
+while (BytesToRead && (r == SCPE_OK)) {
+    uint32 BlockByte = (uint32)(Offset % DynamicBlockSize);
+    uint32 Sector = BlockByte / VHD_Internal_SectorSize;
+    t_bool Present = (VHD_BITMAP_TEST (BitMap, Sector) != 0);
+    uint32 BytesInRun = VHD_Internal_SectorSize - (BlockByte % VHD_Internal_SectorSize);
+    uint32 BytesThisRead = 0;
+
+    while ((BytesInRun < BytesToRead) &&
+           ((VHD_BITMAP_TEST (BitMap, Sector + 1) != 0) == Present)) {
+        ++Sector;
+        BytesInRun += VHD_Internal_SectorSize;
+        }
+    if (BytesInRun > BytesToRead)
+        BytesInRun = BytesToRead;
+    if (Present)
+        r = ReadVirtualDiskFile(hVHD,
+                                buf,
+                                BytesInRun,
+                                &BytesThisRead,
+                                DataOffset + BlockByte);
+    else
+        r = ReadVirtualDisk(hVHD->Parent,
+                            buf,
+                            BytesInRun,
+                            &BytesThisRead,
+                            Offset);
+    BytesToRead -= BytesThisRead;
+    buf += BytesThisRead;
+    Offset += BytesThisRead;
+    *BytesRead += BytesThisRead;
+    if (BytesThisRead != BytesInRun)
+        break;
+    }
+return r;
+}
+
+/* Copy the sectors a partially populated block lacks from the parent so that writes can go straight to it */
+static t_stat
+FillVirtualDiskPartialBlock(VHDHANDLE hVHD,
+                            uint32 BlockNumber)
+{
+uint32 DynamicBlockSize = NtoHl (hVHD->Dynamic.BlockSize);
+uint32 SectorsPerBlock = DynamicBlockSize / VHD_Internal_SectorSize;
+uint64 DataOffset = VHD_Internal_SectorSize * ((uint64)(NtoHl (hVHD->BAT[BlockNumber]) + hVHD->BitMapSectors));
+uint8 *BitMap = hVHD->BitMaps[BlockNumber];
+uint8 *BlockData = (uint8 *)malloc (DynamicBlockSize);
+uint32 Sector, RunStart;
+t_stat r = SCPE_OK;
+
+if (BlockData == NULL)
+    return SCPE_MEM;
+if (ReadVirtualDisk(hVHD->Parent,
+                    BlockData,
+                    DynamicBlockSize,
+                    NULL,
+                    (uint64)BlockNumber * DynamicBlockSize)) {
+    free (BlockData);
+    return SCPE_IOERR;
+    }
+for (Sector = 0; (Sector < SectorsPerBlock) && (r == SCPE_OK); ) {
+    if (VHD_BITMAP_TEST (BitMap, Sector)) {
+        ++Sector;
+        continue;
+        }
+    for (RunStart = Sector; (Sector < SectorsPerBlock) && !VHD_BITMAP_TEST (BitMap, Sector); ++Sector)
+        ;
+    r = WriteFilePosition(hVHD->File,
+                          BlockData + RunStart * VHD_Internal_SectorSize,
+                          (Sector - RunStart) * VHD_Internal_SectorSize,
+                          NULL,
+                          DataOffset + RunStart * VHD_Internal_SectorSize);
+    }
+free (BlockData);
+if (r != SCPE_OK)
+    return r;
+free (BitMap);
+hVHD->BitMaps[BlockNumber] = NULL;
+hVHD->BlockState[BlockNumber] = VHD_BLOCK_DIRTY;
+++hVHD->DirtyBitMaps;
+return SCPE_OK;
+}
+
 static t_stat
 ReadVirtualDisk(VHDHANDLE hVHD,
                 uint8 *buf,
@@ -6151,11 +6596,11 @@ if (Offset >= (uint64)NtoHll (hVHD->Footer.CurrentSize)) {
     return SCPE_IOERR;
     }
 if (NtoHl (hVHD->Footer.DiskType) == VHD_DT_Fixed) {
-    if (ReadFilePosition(hVHD->File,
-                         buf,
-                         BytesToRead,
-                         BytesRead,
-                         Offset))
+    if (ReadVirtualDiskFile(hVHD,
+                            buf,
+                            BytesToRead,
+                            BytesRead,
+                            Offset))
         r = SCPE_IOERR;
     return r;
     }
@@ -6176,28 +6621,57 @@ while (BytesToRead && (r == SCPE_OK)) {
     if (BlockNumber != (Offset + BytesToRead) / DynamicBlockSize)
         BytesInRead = (uint32)(((BlockNumber + 1) * DynamicBlockSize) - Offset);
     if (hVHD->BAT[BlockNumber] == VHD_BAT_FREE_ENTRY) {
-        if (!hVHD->Parent) {
+        uint8 Depth = ResolveVirtualDiskBlock (hVHD, BlockNumber);
+
+        if (Depth == VHD_RESOLVE_ZERO) {
             memset (buf, 0, BytesInRead);
             BytesThisRead = BytesInRead;
             }
         else {
-            if (ReadVirtualDisk(hVHD->Parent,
-                                buf,
-                                BytesInRead,
-                                &BytesThisRead,
-                                Offset))
-                r = SCPE_IOERR;
+            if (Depth == VHD_RESOLVE_WALK) {
+                if (ReadVirtualDisk(hVHD->Parent,
+                                    buf,
+                                    BytesInRead,
+                                    &BytesThisRead,
+                                    Offset))
+                    r = SCPE_IOERR;
+                }
+            else {                      /* Read directly from the parent which holds the whole block */
+                VHDHANDLE hParent = hVHD;
+                uint64 BlockOffset;
+
+                while (Depth--)
+                    hParent = hParent->Parent;
+                BlockOffset = VHD_Internal_SectorSize * ((uint64)(NtoHl (hParent->BAT[BlockNumber]) + hParent->BitMapSectors)) + (Offset % DynamicBlockSize);
+                if (ReadVirtualDiskFile(hParent,
+                                        buf,
+                                        BytesInRead,
+                                        &BytesThisRead,
+                                        BlockOffset))
+                    r = SCPE_IOERR;
+                }
             }
         }
     else {
         uint64 BlockOffset = VHD_Internal_SectorSize * ((uint64)(NtoHl (hVHD->BAT[BlockNumber]) + BitMapSectors)) + (Offset % DynamicBlockSize);
 
-        if (ReadFilePosition(hVHD->File,
-                             buf,
-                             BytesInRead,
-                             &BytesThisRead,
-                             BlockOffset))
-            r = SCPE_IOERR;
+        if (GetVirtualDiskBlockState (hVHD, BlockNumber) == VHD_BLOCK_PARTIAL) {
+            if (ReadVirtualDiskPartialBlock(hVHD,
+                                            BlockNumber,
+                                            buf,
+                                            BytesInRead,
+                                            &BytesThisRead,
+                                            Offset))
+                r = SCPE_IOERR;
+            }
+        else {
+            if (ReadVirtualDiskFile(hVHD,
+                                    buf,
+                                    BytesInRead,
+                                    &BytesThisRead,
+                                    BlockOffset))
+                r = SCPE_IOERR;
+            }
         }
     BytesToRead -= BytesThisRead;
     buf = (uint8 *)(((char *)buf) + BytesThisRead);
@@ -6313,7 +6787,6 @@ while (BytesToWrite && (r == SCPE_OK)) {
         uint8 *BitMap = NULL;
         uint32 BitMapBufferSize = VHD_DATA_BLOCK_ALIGNMENT;
         uint8 *BitMapBuffer = NULL;
-        void *BlockData = NULL;
         uint8 *BATUpdateBufferAddress;
         uint32 BATUpdateBufferSize;
         uint64 BATUpdateStorageAddress;
@@ -6330,11 +6803,21 @@ while (BytesToWrite && (r == SCPE_OK)) {
         if ((BitMapSectors * VHD_Internal_SectorSize) > BitMapBufferSize)
             BitMapBufferSize = BitMapSectors * VHD_Internal_SectorSize;
         BitMapBuffer = (uint8 *)calloc(1, BitMapBufferSize + DynamicBlockSize);
-        if (BitMapBufferSize > BitMapSectors * VHD_Internal_SectorSize)
-            BitMap = BitMapBuffer + BitMapBufferSize - BitMapBytes;
-        else
-            BitMap = BitMapBuffer;
+        if (BitMapBuffer == NULL)
+            return SCPE_MEM;
+        /* the bitmap occupies the sectors immediately preceding the block data */
+        BitMap = BitMapBuffer + BitMapBufferSize - BitMapSectors * VHD_Internal_SectorSize;
         memset(BitMap, 0xFF, BitMapBytes);
+        if (hVHD->Parent) { /* Populate the new data block contents from parent VHD */
+            if (ReadVirtualDisk(hVHD->Parent,
+                                BitMapBuffer + BitMapBufferSize,
+                                DynamicBlockSize,
+                                NULL,
+                                (uint64)BlockNumber * DynamicBlockSize)) {
+                free (BitMapBuffer);
+                return SCPE_IOERR;
+                }
+            }
         BlockOffset -= sizeof(hVHD->Footer);
         if (0 == (BlockOffset & (VHD_DATA_BLOCK_ALIGNMENT-1)))
             {  // Already aligned, so use padded BitMapBuffer
@@ -6372,6 +6855,8 @@ while (BytesToWrite && (r == SCPE_OK)) {
         /* the BAT block address is the beginning of the block bitmap */
         BlockOffset -= BitMapSectors * VHD_Internal_SectorSize;
         hVHD->BAT[BlockNumber] = NtoHl((uint32)(BlockOffset / VHD_Internal_SectorSize));
+        if (hVHD->BlockState)
+            hVHD->BlockState[BlockNumber] = VHD_BLOCK_FULL;
         BlockOffset += (BitMapSectors * VHD_Internal_SectorSize) + DynamicBlockSize;
         if (WriteFilePosition(hVHD->File,
                               &hVHD->Footer,
@@ -6404,38 +6889,21 @@ while (BytesToWrite && (r == SCPE_OK)) {
                               NULL,
                               BATUpdateStorageAddress))
             goto Fatal_IO_Error;
-        if (hVHD->Parent)
-            { /* Need to populate data block contents from parent VHD */
-            BlockData = malloc (NtoHl (hVHD->Dynamic.BlockSize));
-
-            if (ReadVirtualDisk(hVHD->Parent,
-                                (uint8*) BlockData,
-                                NtoHl (hVHD->Dynamic.BlockSize),
-                                NULL,
-                                (Offset / NtoHl (hVHD->Dynamic.BlockSize)) * NtoHl (hVHD->Dynamic.BlockSize)))
-                goto Fatal_IO_Error;
-            if (WriteVirtualDisk(hVHD,
-                                 (uint8*) BlockData,
-                                 NtoHl (hVHD->Dynamic.BlockSize),
-                                 NULL,
-                                 (Offset / NtoHl (hVHD->Dynamic.BlockSize)) * NtoHl (hVHD->Dynamic.BlockSize)))
-                goto Fatal_IO_Error;
-            free(BlockData);
-            }
         continue;
 Fatal_IO_Error:
-        free (BitMap);
-        free (BlockData);
         r = SCPE_IOERR;
         }
     else {
         uint64 BlockOffset = VHD_Internal_SectorSize * ((uint64)(NtoHl(hVHD->BAT[BlockNumber]) + BitMapSectors)) + (Offset % DynamicBlockSize);
 
-        if (WriteFilePosition(hVHD->File,
-                              buf,
-                              BytesInWrite,
-                              &BytesThisWrite,
-                              BlockOffset))
+        if ((GetVirtualDiskBlockState (hVHD, BlockNumber) == VHD_BLOCK_PARTIAL) &&
+            (FillVirtualDiskPartialBlock (hVHD, BlockNumber) != SCPE_OK))
+            r = SCPE_IOERR;
+        else if (WriteFilePosition(hVHD->File,
+                                   buf,
+                                   BytesInWrite,
+                                   &BytesThisWrite,
+                                   BlockOffset))
             r = SCPE_IOERR;
         }
 IO_Done:
@@ -6740,6 +7208,158 @@ struct disk_test_coverage {
     uint32 *data;
     };
 
+#if defined (SIM_ASYNCH_IO)
+/* Queue several asynchronous reads at once and check that each callback
+   is delivered, in order, with the expected data */
+
+#define DISK_TEST_ASYNC_REQS 8
+
+static uint32 disk_test_async_done;
+static t_stat disk_test_async_status;
+
+static void sim_disk_test_async_callback (UNIT *uptr, t_stat status)
+{
+++disk_test_async_done;
+if (status != SCPE_OK)
+    disk_test_async_status = status;
+}
+
+/* Requests counted in the queue depth and latency histograms */
+
+static void sim_disk_test_ioq_counts (UNIT *uptr, uint32 *depth, uint32 *latency)
+{
+struct disk_context *ctx = (struct disk_context *)uptr->disk_ctx;
+int i;
+
+*depth = *latency = 0;
+pthread_mutex_lock (&disk_pool.lock);
+for (i = 0; i < DISK_HIST_DEPTH; i++)
+    *depth += ctx->depth_hist[i];
+for (i = 0; i < DISK_HIST_LATENCY; i++)
+    *latency += ctx->latency_hist[i];
+pthread_mutex_unlock (&disk_pool.lock);
+}
+
+static t_stat sim_disk_test_async (UNIT *uptr, struct disk_test_coverage *c, uint32 uint32s_per_sector)
+{
+t_bool saved_asynch_enabled = sim_asynch_enabled;
+t_seccnt sects = c->max_xfer_sectors / DISK_TEST_ASYNC_REQS;
+t_seccnt sectors_read[DISK_TEST_ASYNC_REQS];
+t_stat r = SCPE_OK;
+uint32 i, j;
+uint32 depth_before, latency_before, depth_after, latency_after;
+
+if (sects > c->total_sectors / DISK_TEST_ASYNC_REQS)
+    sects = c->total_sectors / DISK_TEST_ASYNC_REQS;
+if (sects == 0)
+    return SCPE_OK;
+sim_asynch_enabled = TRUE;
+sim_disk_set_async (uptr, 0);
+disk_test_async_done = 0;
+disk_test_async_status = SCPE_OK;
+sim_disk_test_ioq_counts (uptr, &depth_before, &latency_before);
+memset (c->data, 0, sects * DISK_TEST_ASYNC_REQS * uint32s_per_sector * sizeof (*c->data));
+for (i = 0; i < DISK_TEST_ASYNC_REQS; i++)
+    sim_disk_rdsect_a (uptr, i * sects, (uint8 *)&c->data[i * sects * uint32s_per_sector], &sectors_read[i], sects, &sim_disk_test_async_callback);
+_disk_cancel (uptr);                                    /* wait for them all */
+_disk_completion_dispatch (uptr);
+sim_disk_test_ioq_counts (uptr, &depth_after, &latency_after);
+sim_disk_clr_async (uptr);
+sim_asynch_enabled = saved_asynch_enabled;
+AIO_UPDATE_QUEUE;
+sim_cancel (uptr);                                      /* discard completion activations */
+if ((disk_test_async_done != DISK_TEST_ASYNC_REQS) || (disk_test_async_status != SCPE_OK)) {
+    sim_printf ("Asynchronous reads: %u of %u completed, status: %s\n", disk_test_async_done, DISK_TEST_ASYNC_REQS, sim_error_text (disk_test_async_status));
+    return SCPE_IERR;
+    }
+if ((depth_after - depth_before != DISK_TEST_ASYNC_REQS) ||
+    (latency_after - latency_before != DISK_TEST_ASYNC_REQS)) {
+    sim_printf ("Asynchronous queue histograms counted %u queued and %u completed of %u requests\n",
+                depth_after - depth_before, latency_after - latency_before, DISK_TEST_ASYNC_REQS);
+    return SCPE_IERR;
+    }
+for (i = 0; (i < sects * DISK_TEST_ASYNC_REQS) && (r == SCPE_OK); i++) {
+    if (sectors_read[i / sects] != sects)
+        r = SCPE_IERR;
+    for (j = 0; (j < uint32s_per_sector) && (r == SCPE_OK); j++)
+        if (c->data[i * uint32s_per_sector + j] != i) {
+            sim_printf ("Asynchronous read of sector %u(0x%X) has unexpected data at offset 0x%X: 0x%08X\n",
+                        i, i, j, c->data[i * uint32s_per_sector + j]);
+            r = SCPE_IERR;
+            }
+    }
+if (r == SCPE_OK)
+    sim_printf("Asynchronous Reading OK\n");
+return r;
+}
+#endif
+
+/* Layer a differencing disk over a populated VHD, check that reads resolve through it and writes stay in it */
+static t_stat sim_disk_test_differencing (UNIT *uptr, struct disk_test_coverage *c, uint32 uint32s_per_sector)
+{
+struct disk_context *ctx = (struct disk_context *)uptr->disk_ctx;
+size_t sector_size = ctx->sector_size;
+size_t xfer_element_size = ctx->xfer_element_size;
+char *parent = strdup (uptr->filename);
+char diffspec[2 * CBUFSIZE];
+char *child;
+t_lba write_lba = c->total_sectors / 3;
+t_seccnt write_sects = c->max_xfer_sectors / 2;
+t_seccnt sects, sectors_done;
+t_lba lba;
+int32 saved_switches = sim_switches;
+int pass;
+uint32 i;
+t_stat r;
+
+snprintf (diffspec, sizeof (diffspec), "%s-Diff.VHD %s", parent, parent);
+child = strdup (diffspec);
+*strchr (child, ' ') = '\0';
+if (write_lba + write_sects > c->total_sectors)
+    write_sects = c->total_sectors - write_lba;
+sim_disk_detach (uptr);
+sim_switches = SWMASK ('D') | (saved_switches & SWMASK ('S'));   /* TESTLIB -S maps the parent */
+r = sim_disk_attach_ex (uptr, diffspec, sector_size, xfer_element_size, TRUE, 0, NULL, 0, 0, NULL);
+sim_switches = saved_switches;
+for (pass = 0; (pass < 2) && (r == SCPE_OK); pass++) {
+    for (lba = 0; (lba < c->total_sectors) && (r == SCPE_OK); lba += sects) {
+        sects = c->max_xfer_sectors;
+        if (lba + sects > c->total_sectors)
+            sects = c->total_sectors - lba;
+        r = sim_disk_rdsect (uptr, lba, (uint8 *)c->data, &sectors_done, sects);
+        if ((r == SCPE_OK) && (sectors_done != sects))
+            r = SCPE_IERR;
+        for (i = 0; (i < sects * uint32s_per_sector) && (r == SCPE_OK); i++) {
+            t_lba sector = lba + i / uint32s_per_sector;
+            uint32 expected = ((pass > 0) && (sector >= write_lba) && (sector < write_lba + write_sects)) ? ~sector : sector;
+
+            if (c->data[i] != expected) {
+                sim_printf ("Differencing sector %u(0x%X) has unexpected data at offset 0x%X: 0x%08X\n",
+                            sector, sector, (uint32)(i % uint32s_per_sector), c->data[i]);
+                r = SCPE_IERR;
+                }
+            }
+        }
+    if ((pass == 0) && (r == SCPE_OK)) {
+        for (i = 0; i < write_sects * uint32s_per_sector; i++)
+            c->data[i] = ~(write_lba + i / uint32s_per_sector);
+        r = sim_disk_wrsect (uptr, write_lba, (uint8 *)c->data, &sectors_done, write_sects);
+        if ((r == SCPE_OK) && (sectors_done != write_sects))
+            r = SCPE_IERR;
+        }
+    }
+if (r == SCPE_OK)
+    sim_printf("Differencing OK\n");
+if (uptr->flags & UNIT_ATT)
+    sim_disk_detach (uptr);
+(void)remove (child);
+if (r == SCPE_OK)
+    r = sim_disk_attach_ex (uptr, parent, sector_size, xfer_element_size, TRUE, 0, NULL, 0, 0, NULL);
+free (child);
+free (parent);
+return r;
+}
+
 static t_stat sim_disk_test_exercise (UNIT *uptr)
 {
 struct disk_context *ctx = (struct disk_context *)uptr->disk_ctx;
@@ -6838,6 +7458,10 @@ if (!(uptr->flags & UNIT_RO)) { /* Only test drives open Read/Write - Read Only
             r = SCPE_IERR;
             }
         }
+#if defined (SIM_ASYNCH_IO)
+    if (r == SCPE_OK)
+        r = sim_disk_test_async (uptr, c, uint32s_per_sector);
+#endif
     if (r == SCPE_OK) { /* If still good, then do EOF and beyond boundary test */
         t_offset current_unit_size = ((t_offset)uptr->capac)*ctx->capac_factor*((dptr->flags & DEV_SECTORS) ? ctx->sector_size : 1);
         t_seccnt sectors_read, sectors_to_read;
@@ -6851,6 +7475,8 @@ if (!(uptr->flags & UNIT_RO)) { /* Only test drives open Read/Write - Read Only
                 r = SCPE_IERR;
             }
         }
+    if ((r == SCPE_OK) && (DK_GET_FMT (uptr) == DKUF_F_VHD))
+        r = sim_disk_test_differencing (uptr, c, uint32s_per_sector);
     }
 free (c->data);
 free (c->wbitmap);
@@ -54,6 +54,13 @@
    sim_byte_swap_data -      swap data elements inplace in buffer
    sim_shmem_open            create or attach to a shared memory region
    sim_shmem_close           close a shared memory region
+   sim_shmem_map_file        map an open file's contents shared read only
+   sim_shmem_pid             identify this process to users of a shared region
+   sim_shmem_pid_alive       test whether a process from sim_shmem_pid still runs
+   sim_memory_alloc          allocate zeroed memory populated on first touch
+   sim_memory_free           free memory from sim_memory_alloc
+   sim_memory_release        zero a range, returning its pages to the host
+   sim_memory_hugepages      request (or stop requesting) huge page backing
    sim_chdir                 change working directory
    sim_mkdir                 create a directory
    sim_rmdir                 remove a directory
@@ -749,14 +756,73 @@ void sim_shmem_close (SHMEM *shmem)
 {
 if (shmem == NULL)
     return;
-if (shmem->shm_base != NULL)
-    UnmapViewOfFile (shmem->shm_base);
+if (shmem->shm_base != NULL) {
+    if (shmem->hMapping == INVALID_HANDLE_VALUE)
+        VirtualFree (shmem->shm_base, 0, MEM_RELEASE);  /* private copy */
+    else
+        UnmapViewOfFile (shmem->shm_base);
+    }
 if (shmem->hMapping != INVALID_HANDLE_VALUE)
     CloseHandle (shmem->hMapping);
 free (shmem->shm_name);
 free (shmem);
 }
 
+t_stat sim_shmem_map_file (FILE *f, t_bool private_writes, size_t min_size, SHMEM **shmem, void **addr, size_t *size)
+{
+t_offset fsize = sim_fsize_ex (f);
+size_t msize;
+
+*shmem = NULL;
+*addr = NULL;
+if ((fsize < 0) || ((t_offset)((size_t)fsize) != fsize))
+    return SCPE_NOFNC;
+msize = (size_t)fsize;
+if (private_writes && (min_size > msize))
+    msize = min_size;
+if (msize == 0)
+    return SCPE_NOFNC;
+fflush (f);
+*shmem = (SHMEM *)calloc (1, sizeof(**shmem));
+if (*shmem == NULL)
+    return SCPE_MEM;
+(*shmem)->hMapping = INVALID_HANDLE_VALUE;
+(*shmem)->shm_size = msize;
+if (msize > (size_t)fsize) {            /* Views can't extend past the file, */
+    (*shmem)->shm_base = VirtualAlloc (NULL, msize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if ((*shmem)->shm_base == NULL) {   /* so read it into a private copy */
+        sim_shmem_close (*shmem);
+        *shmem = NULL;
+        return SCPE_MEM;
+        }
+    if ((sim_fseeko (f, 0, SEEK_SET) != 0) ||
+        (fread ((*shmem)->shm_base, 1, (size_t)fsize, f) != (size_t)fsize)) {
+        sim_shmem_close (*shmem);
+        *shmem = NULL;
+        return SCPE_IOERR;
+        }
+    *addr = (*shmem)->shm_base;
+    *size = (*shmem)->shm_size;
+    return SCPE_OK;
+    }
+(*shmem)->hMapping = CreateFileMappingA ((HANDLE)_get_osfhandle (_fileno (f)), NULL, private_writes ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, NULL);
+if ((*shmem)->hMapping == NULL) {
+    (*shmem)->hMapping = INVALID_HANDLE_VALUE;
+    sim_shmem_close (*shmem);
+    *shmem = NULL;
+    return SCPE_OPENERR;
+    }
+(*shmem)->shm_base = MapViewOfFile ((*shmem)->hMapping, private_writes ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+if ((*shmem)->shm_base == NULL) {
+    sim_shmem_close (*shmem);
+    *shmem = NULL;
+    return SCPE_OPENERR;
+    }
+*addr = (*shmem)->shm_base;
+*size = (*shmem)->shm_size;
+return SCPE_OK;
+}
+
 int32 sim_shmem_atomic_add (int32 *p, int32 v)
 {
 return InterlockedExchangeAdd ((volatile long *) p,v) + (v);
@@ -767,6 +833,58 @@ t_bool sim_shmem_atomic_cas (int32 *ptr, int32 oldv, int32 newv)
 return (InterlockedCompareExchange ((LONG volatile *) ptr, newv, oldv) == oldv);
 }
 
+int32 sim_shmem_pid (void)
+{
+return (int32)GetCurrentProcessId ();
+}
+
+t_bool sim_shmem_pid_alive (int32 pid)
+{
+HANDLE hProcess = OpenProcess (SYNCHRONIZE, FALSE, (DWORD)pid);
+DWORD wait;
+
+if (hProcess == NULL)
+    return (GetLastError () == ERROR_ACCESS_DENIED);
+wait = WaitForSingleObject (hProcess, 0);
+CloseHandle (hProcess);
+return (wait == WAIT_TIMEOUT);
+}
+
+void *sim_memory_alloc (size_t size)
+{
+return VirtualAlloc (NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+}
+
+void sim_memory_free (void *addr, size_t size)
+{
+if (addr != NULL)
+    VirtualFree (addr, 0, MEM_RELEASE);
+}
+
+void sim_memory_release (void *addr, size_t size)
+{
+SYSTEM_INFO SysInfo;
+size_t page, head, pages;
+
+GetSystemInfo (&SysInfo);
+page = SysInfo.dwPageSize;
+head = (page - ((size_t)addr & (page - 1))) & (page - 1);
+if (size < head + page) {
+    memset (addr, 0, size);
+    return;
+    }
+pages = (size - head) & ~(page - 1);
+memset (addr, 0, head);
+memset ((char *)addr + head + pages, 0, size - head - pages);
+VirtualFree ((char *)addr + head, pages, MEM_DECOMMIT);
+VirtualAlloc ((char *)addr + head, pages, MEM_COMMIT, PAGE_READWRITE);
+}
+
+t_stat sim_memory_hugepages (void *addr, size_t size, t_bool enable)
+{
+return enable ? SCPE_NOFNC : SCPE_OK;
+}
+
 #else /* !defined(_WIN32) */
 #include <unistd.h>
 int sim_set_fsize (FILE *fptr, t_addr size)
@@ -866,7 +984,11 @@ return -1;
 
 #if defined (HAVE_SHM_OPEN)
 #include <sys/mman.h>
+#if !defined (MAP_ANONYMOUS) && defined (MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
 #endif
+#include <signal.h>
 
 struct SHMEM {
     int shm_fd;
@@ -955,6 +1077,63 @@ free (shmem);
 #endif
 }
 
+/* Map the whole of an open file.  Read only mappings share the host's
+   page cache with every other process mapping the same file.  With
+   private_writes, stores land in copy-on-write pages private to this
+   process and never reach the file, and the mapping is at least
+   min_size bytes: past the end of the file it is zero filled anonymous
+   memory with the file mapped over its start. */
+
+t_stat sim_shmem_map_file (FILE *f, t_bool private_writes, size_t min_size, SHMEM **shmem, void **addr, size_t *size)
+{
+#if defined (HAVE_SHM_OPEN)
+t_offset fsize = sim_fsize_ex (f);
+size_t msize;
+void *base;
+
+*shmem = NULL;
+*addr = NULL;
+if ((fsize < 0) || ((t_offset)((size_t)fsize) != fsize))
+    return SCPE_NOFNC;
+msize = (size_t)fsize;
+if (private_writes && (min_size > msize))
+    msize = min_size;
+if (msize == 0)
+    return SCPE_NOFNC;
+fflush (f);
+if (msize > (size_t)fsize) {
+#if defined (MAP_ANONYMOUS)
+    base = mmap (NULL, msize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if ((base != MAP_FAILED) && (fsize > 0) &&
+        (mmap (base, (size_t)fsize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fileno (f), 0) == MAP_FAILED)) {
+        munmap (base, msize);
+        base = MAP_FAILED;
+        }
+#else
+    return SCPE_NOFNC;
+#endif
+    }
+else
+    base = mmap (NULL, msize, PROT_READ | (private_writes ? PROT_WRITE : 0), private_writes ? MAP_PRIVATE : MAP_SHARED, fileno (f), 0);
+if (base == MAP_FAILED)
+    return SCPE_OPENERR;
+*shmem = (SHMEM *)calloc (1, sizeof(**shmem));
+if (*shmem == NULL) {
+    munmap (base, msize);
+    return SCPE_MEM;
+    }
+(*shmem)->shm_fd = -1;                  /* Nothing to unlink on close */
+(*shmem)->shm_size = msize;
+(*shmem)->shm_base = base;
+*addr = base;
+*size = msize;
+return SCPE_OK;
+#else
+*shmem = NULL;
+return SCPE_NOFNC;
+#endif
+}
+
 int32 sim_shmem_atomic_add (int32 *p, int32 v)
 {
 #if defined (__GCC_HAVE_SYNC_COMPARE_AND_SWAP_4)
@@ -978,6 +1157,16 @@ else
 #endif
 }
 
+int32 sim_shmem_pid (void)
+{
+return (int32)getpid ();
+}
+
+t_bool sim_shmem_pid_alive (int32 pid)
+{
+return (kill ((pid_t)pid, 0) == 0) || (errno == EPERM);
+}
+
 #else /* !(defined (__linux__) || defined (__APPLE__)) */
 
 t_stat sim_shmem_open (const char *name, size_t size, SHMEM **shmem, void **addr)
@@ -989,6 +1178,12 @@ void sim_shmem_close (SHMEM *shmem)
 {
 }
 
+t_stat sim_shmem_map_file (FILE *f, t_bool private_writes, size_t min_size, SHMEM **shmem, void **addr, size_t *size)
+{
+*shmem = NULL;
+return SCPE_NOFNC;
+}
+
 int32 sim_shmem_atomic_add (int32 *p, int32 v)
 {
 return -1;
@@ -999,7 +1194,97 @@ t_bool sim_shmem_atomic_cas (int32 *ptr, int32 oldv, int32 newv)
 return FALSE;
 }
 
+int32 sim_shmem_pid (void)
+{
+return 1;
+}
+
+t_bool sim_shmem_pid_alive (int32 pid)
+{
+return TRUE;
+}
+
 #endif /* defined (__linux__) || defined (__APPLE__) */
+
+/* Guest memory.  Anonymous mappings are zero filled by the host as
+   pages are first touched, so a large memory which is mostly unused
+   costs only what the guest actually references. */
+
+#if defined (HAVE_SHM_OPEN)
+#include <sys/mman.h>
+#if !defined (MAP_ANONYMOUS) && defined (MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#endif
+
+#define SIM_HUGEPAGE_SIZE (2*1024*1024)
+
+void *sim_memory_alloc (size_t size)
+{
+#if defined (HAVE_SHM_OPEN) && defined (MAP_ANONYMOUS)
+size_t align = (size >= SIM_HUGEPAGE_SIZE) ? SIM_HUGEPAGE_SIZE : 0;
+char *base = (char *)mmap (NULL, size + align, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+size_t head;
+
+if (base == (char *)MAP_FAILED)
+    return NULL;
+if (align == 0)
+    return base;
+/* Trim so that the region is huge page aligned */
+head = (align - ((size_t)base & (align - 1))) & (align - 1);
+if (head)
+    munmap (base, head);
+if (align - head)
+    munmap (base + head + size, align - head);
+return base + head;
+#else
+return calloc (1, size);
+#endif
+}
+
+void sim_memory_free (void *addr, size_t size)
+{
+if (addr == NULL)
+    return;
+#if defined (HAVE_SHM_OPEN) && defined (MAP_ANONYMOUS)
+munmap (addr, size);
+#else
+free (addr);
+#endif
+}
+
+void sim_memory_release (void *addr, size_t size)
+{
+#if defined (HAVE_SHM_OPEN) && defined (MAP_ANONYMOUS) && defined (MADV_DONTNEED) && defined (__linux__)
+size_t page = (size_t)sysconf (_SC_PAGESIZE);
+size_t head = (page - ((size_t)addr & (page - 1))) & (page - 1);
+size_t pages;
+
+if (size < head + page) {
+    memset (addr, 0, size);
+    return;
+    }
+pages = (size - head) & ~(page - 1);
+memset (addr, 0, head);
+memset ((char *)addr + head + pages, 0, size - head - pages);
+/* Private anonymous pages read back as zero after MADV_DONTNEED on Linux */
+if (madvise ((char *)addr + head, pages, MADV_DONTNEED))
+    memset ((char *)addr + head, 0, pages);
+#else
+memset (addr, 0, size);
+#endif
+}
+
+t_stat sim_memory_hugepages (void *addr, size_t size, t_bool enable)
+{
+#if defined (HAVE_SHM_OPEN) && defined (MADV_HUGEPAGE)
+if (madvise (addr, size, enable ? MADV_HUGEPAGE : MADV_NOHUGEPAGE))
+    return sim_messagef (SCPE_NOFNC, "Transparent huge pages unavailable: %s\n", strerror (errno));
+return SCPE_OK;
+#else
+return enable ? sim_messagef (SCPE_NOFNC, "Huge pages are not supported on this host\n") : SCPE_OK;
+#endif
+}
 #endif /* defined (_WIN32) */
 
 #if defined(__VAX)
@@ -98,8 +98,15 @@ const char *sim_get_os_error_text (int error);
 typedef struct SHMEM SHMEM;
 t_stat sim_shmem_open (const char *name, size_t size, SHMEM **shmem, void **addr);
 void sim_shmem_close (SHMEM *shmem);
+t_stat sim_shmem_map_file (FILE *f, t_bool private_writes, size_t min_size, SHMEM **shmem, void **addr, size_t *size);
+void *sim_memory_alloc (size_t size);
+void sim_memory_free (void *addr, size_t size);
+void sim_memory_release (void *addr, size_t size);
+t_stat sim_memory_hugepages (void *addr, size_t size, t_bool enable);
 int32 sim_shmem_atomic_add (int32 *ptr, int32 val);
 t_bool sim_shmem_atomic_cas (int32 *ptr, int32 oldv, int32 newv);
+int32 sim_shmem_pid (void);
+t_bool sim_shmem_pid_alive (int32 pid);
 
 extern t_bool sim_taddr_64;         /* t_addr is > 32b and Large File Support available */
 extern t_bool sim_toffset_64;       /* Large File (>2GB) file I/O support */
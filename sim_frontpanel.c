@@ -84,6 +84,10 @@ return 0;
 #include <unistd.h>
 #define msleep(n) usleep(1000*n)
 #include <sys/wait.h>
+#if defined (HAVE_SHM_OPEN)
+#include <sys/mman.h>
+#include <fcntl.h>
+#endif
 #if defined (__APPLE__)
 #define HAVE_STRUCT_TIMESPEC 1   /* OSX defined the structure but doesn't tell us */
 #endif
@@ -129,6 +133,33 @@ typedef struct {
     size_t bit_count;
     } REG;
 
+/*
+   Register block published by the simulator's PUBLISH remote console
+   command.  This layout must match PUBLISH_BLOCK in sim_console.c.
+   The sequence counter is odd while the simulator is rewriting the
+   block, so a copy is only consistent if the same even sequence value
+   is seen before and after it was taken.
+ */
+#define SIM_PANEL_SHMEM_MAGIC    0x53484D50     /* "SHMP" */
+#define SIM_PANEL_SHMEM_VERSION  1
+
+typedef struct {
+    unsigned int        magic;
+    unsigned int        version;
+    unsigned int        reg_count;
+    volatile unsigned int sequence;         /* odd while update in progress */
+    unsigned long long  simulation_time;
+    unsigned long long  values[1];          /* reg_count register values */
+    } SIM_PANEL_SHMEM;
+
+#if defined(_WIN32)
+#define _panel_memory_barrier() MemoryBarrier()
+#elif defined(__GNUC__)
+#define _panel_memory_barrier() __sync_synchronize()
+#else
+#define _panel_memory_barrier()
+#endif
+
 struct PANEL {
     PANEL                   *parent;        /* Device Panels can have parent panels */
     char                    *path;          /* simulator path */
@@ -172,6 +203,16 @@ struct PANEL {
     unsigned int            sample_frequency;
     unsigned int            sample_dither_pct;
     unsigned int            sample_depth;
+    int                     shmem_enabled;  /* deliver registers via shared memory */
+    char                    shmem_name[64]; /* published register segment name */
+    void                    *shmem_map;     /* mapped segment */
+    size_t                  shmem_size;
+    volatile SIM_PANEL_SHMEM *shmem;        /* published register block */
+    unsigned long long      *shmem_values;  /* consistent copy of published values */
+    size_t                  shmem_count;
+#if defined(_WIN32)
+    HANDLE                  hShmem;
+#endif
     int                     debug;
     char                    *simulator_version;
     int                     radix;
@@ -220,6 +261,8 @@ static const char *register_collect_prefix = "collect ";
 static const char *register_collect_mid1 = " samples every ";
 static const char *register_collect_mid2 = " cycles dither ";
 static const char *register_collect_mid3 = " percent ";
+static const char *register_publish_prefix = "publish ";
+static const char *register_publish_stop = "publish stop";
 static const char *register_get_postfix = "sampleout";
 static const char *register_get_start = "# REGISTERS-START";
 static const char *register_get_end = "# REGISTERS-DONE";
@@ -634,6 +677,188 @@ free (buf);
 return 0;
 }
 
+static void
+_panel_shmem_release (PANEL *p)
+{
+if (p->shmem_map == NULL)
+    return;
+_panel_debug (p, DBG_THR, "Releasing shared memory register block %s", NULL, 0, p->shmem_name);
+#if defined(_WIN32)
+UnmapViewOfFile (p->shmem_map);
+CloseHandle (p->hShmem);
+#elif defined(HAVE_SHM_OPEN)
+munmap (p->shmem_map, p->shmem_size);
+#endif
+p->shmem_map = NULL;
+p->shmem = NULL;
+free (p->shmem_values);
+p->shmem_values = NULL;
+p->shmem_count = 0;
+}
+
+static int
+_panel_shmem_open (PANEL *p, size_t size, size_t count)
+{
+#if defined(_WIN32)
+SYSTEM_INFO SysInfo;
+
+GetSystemInfo (&SysInfo);
+p->hShmem = OpenFileMappingA (FILE_MAP_READ, FALSE, p->shmem_name);
+if (p->hShmem == NULL)
+    return -1;
+p->shmem_map = MapViewOfFile (p->hShmem, FILE_MAP_READ, 0, 0, 0);
+if (p->shmem_map == NULL) {
+    CloseHandle (p->hShmem);
+    return -1;
+    }
+p->shmem = (SIM_PANEL_SHMEM *)((char *)p->shmem_map + SysInfo.dwPageSize);
+#elif defined(HAVE_SHM_OPEN)
+char name[sizeof (p->shmem_name) + 1];
+int fd;
+
+sprintf (name, "/%s", p->shmem_name);
+fd = shm_open (name, O_RDONLY, 0);
+if (fd == -1)
+    return -1;
+p->shmem_map = mmap (NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+close (fd);
+if (p->shmem_map == MAP_FAILED) {
+    p->shmem_map = NULL;
+    return -1;
+    }
+p->shmem = (SIM_PANEL_SHMEM *)p->shmem_map;
+#else
+return -1;
+#endif
+p->shmem_size = size;
+p->shmem_count = count;
+p->shmem_values = (unsigned long long *)_panel_malloc (count * sizeof (*p->shmem_values));
+if ((p->shmem_values == NULL)                       ||
+    (p->shmem->magic != SIM_PANEL_SHMEM_MAGIC)      ||
+    (p->shmem->version != SIM_PANEL_SHMEM_VERSION)  ||
+    (p->shmem->reg_count != count)) {
+    _panel_shmem_release (p);
+    return -1;
+    }
+return 0;
+}
+
+/*
+   Ask the simulator to publish the panel's registers in a shared
+   memory segment and map it.  Registers are published in panel
+   register order with each array element occupying its own slot.
+   Returns -1 if the registers must be delivered as text instead.
+ */
+static int
+_panel_shmem_publish (PANEL *p)
+{
+size_t i, count = 0, buf_data = 0, buf_needed = 1;
+char *buf, *response = NULL;
+int cmd_stat;
+static int shmem_serial = 0;
+
+pthread_mutex_lock (&p->io_lock);
+for (i=0; i<p->reg_count; i++) {
+    if (p->regs[i].bits) {
+        pthread_mutex_unlock (&p->io_lock);
+        _panel_debug (p, DBG_THR, "Bit sample registers are delivered as text", NULL, 0);
+        return -1;
+        }
+    buf_needed += 20 + strlen (p->regs[i].name) + (p->regs[i].device_name ? strlen (p->regs[i].device_name) : 0);
+    count += (p->regs[i].element_count > 0) ? p->regs[i].element_count : 1;
+    }
+if (count == 0) {
+    pthread_mutex_unlock (&p->io_lock);
+    return -1;
+    }
+buf = (char *)_panel_malloc (buf_needed);
+if (!buf) {
+    pthread_mutex_unlock (&p->io_lock);
+    return -1;
+    }
+*buf = '\0';
+for (i=0; i<p->reg_count; i++) {
+    sprintf (buf + buf_data, "%s%s", (i != 0) ? "," : "", p->regs[i].indirect ? "-I " : "");
+    buf_data += strlen (buf + buf_data);
+    if (p->regs[i].device_name) {
+        sprintf (buf + buf_data, "%s ", p->regs[i].device_name);
+        buf_data += strlen (buf + buf_data);
+        }
+    if (p->regs[i].element_count > 0)
+        sprintf (buf + buf_data, "%s[0:%d]", p->regs[i].name, (int)(p->regs[i].element_count-1));
+    else
+        sprintf (buf + buf_data, "%s", p->regs[i].name);
+    buf_data += strlen (buf + buf_data);
+    }
+#if defined(_WIN32)
+sprintf (p->shmem_name, "simh-panel-%d-%d", (int)GetCurrentProcessId (), ++shmem_serial);
+#else
+sprintf (p->shmem_name, "simh-panel-%d-%d", (int)getpid (), ++shmem_serial);
+#endif
+pthread_mutex_unlock (&p->io_lock);
+if ((_panel_sendf (p, &cmd_stat, &response, "%s%s every %d%s%s\r", register_publish_prefix, p->shmem_name,
+                                                                  p->usecs_between_callbacks, register_repeat_units, buf)) ||
+    (cmd_stat)) {
+    _panel_debug (p, DBG_THR, "Shared memory register publishing unavailable: %s", NULL, 0, response ? response : "");
+    free (response);
+    free (buf);
+    return -1;
+    }
+free (response);
+free (buf);
+if (_panel_shmem_open (p, sizeof (SIM_PANEL_SHMEM) + (count - 1) * sizeof (p->shmem->values[0]), count)) {
+    _panel_debug (p, DBG_THR, "Can't map shared memory register block %s", NULL, 0, p->shmem_name);
+    _panel_sendf (p, &cmd_stat, NULL, "%s", register_publish_stop);
+    return -1;
+    }
+_panel_debug (p, DBG_THR, "Registers published in shared memory block %s", NULL, 0, p->shmem_name);
+_panel_sendf (p, &cmd_stat, NULL, "%s", register_repeat_stop); /* text register delivery no longer needed */
+return 0;
+}
+
+/*
+   Copy a consistent snapshot of the published register block into the
+   panel's register buffers.  Called with io_lock held.  Returns -1 if
+   the simulator was busy updating the block on every attempt.
+ */
+static int
+_panel_shmem_read (PANEL *p)
+{
+volatile SIM_PANEL_SHMEM *shm = p->shmem;
+unsigned int sequence;
+unsigned long long simulation_time = 0;
+size_t i, j, k;
+int tries;
+
+for (tries = 0; tries < 100; tries++) {
+    sequence = shm->sequence;
+    if (sequence & 1)                               /* update in progress? */
+        continue;
+    _panel_memory_barrier ();
+    simulation_time = shm->simulation_time;
+    for (k = 0; k < p->shmem_count; k++)
+        p->shmem_values[k] = shm->values[k];
+    _panel_memory_barrier ();
+    if (sequence == shm->sequence)                  /* unchanged while copying? */
+        break;
+    }
+if (tries == 100)
+    return -1;
+p->simulation_time = simulation_time;
+for (i=k=0; i<p->reg_count; i++) {
+    REG *r = &p->regs[i];
+    size_t elements = (r->element_count > 0) ? r->element_count : 1;
+
+    for (j = 0; j < elements; j++, k++) {
+        if (little_endian)
+            memcpy ((char *)(r->addr) + (j * r->size), &p->shmem_values[k], r->size);
+        else
+            memcpy ((char *)(r->addr) + (j * r->size), ((char *)&p->shmem_values[k]) + sizeof(p->shmem_values[k])-r->size, r->size);
+        }
+    }
+return 0;
+}
+
 static PANEL **panels = NULL;
 static int panel_count = 0;
 static char *sim_panel_error_buf = NULL;
@@ -1416,6 +1641,28 @@ pthread_mutex_unlock (&panel->io_lock);
 return 0;
 }
 
+int
+sim_panel_set_shared_memory (PANEL *panel, int enable)
+{
+if (!panel) {
+    sim_panel_set_error (NULL, "Invalid Panel");
+    return -1;
+    }
+#if !defined(_WIN32) && !defined(HAVE_SHM_OPEN)
+if (enable) {
+    sim_panel_set_error (NULL, "Shared memory is not available on this platform");
+    return -1;
+    }
+#endif
+pthread_mutex_lock (&panel->io_lock);
+if (panel->shmem_enabled != (enable != 0)) {
+    panel->shmem_enabled = (enable != 0);
+    panel->new_register = 1;                        /* re-establish register delivery */
+    }
+pthread_mutex_unlock (&panel->io_lock);
+return 0;
+}
+
 int
 sim_panel_set_sampling_parameters_ex (PANEL *panel,
                                       unsigned int sample_frequency,
@@ -2480,8 +2727,27 @@ while ((p->sock != INVALID_SOCKET) &&
     /*  1) update the query string if it has changed                            */
     /*     (only really happens at startup)                                     */
     /*  2) update register state by polling if the simulator is halted          */
-    msleep (500);
+    /* when registers are published in shared memory, this is also where the   */
+    /* running simulator's register state is picked up at the callback rate     */
+    if (p->shmem && (p->State == Run)) {
+        int msecs = (interval < 1000) ? 1 : interval/1000;
+
+        msleep (msecs);
+        }
+    else
+        msleep (500);
     pthread_mutex_lock (&p->io_lock);
+    if (new_register) {
+        pthread_mutex_unlock (&p->io_lock);
+        if (p->shmem) {                             /* stop any previous publishing */
+            _panel_sendf (p, &cmd_stat, NULL, "%s", register_publish_stop);
+            _panel_shmem_release (p);
+            }
+        if ((p->shmem_enabled) &&
+            (0 == _panel_shmem_publish (p)))
+            new_register = 0;                       /* registers delivered via shared memory */
+        pthread_mutex_lock (&p->io_lock);
+        }
     if (new_register) {
         size_t repeat_data = strlen (register_repeat_prefix) +  /* prefix */
                              20                              +  /* max int width */
@@ -2530,8 +2796,23 @@ while ((p->sock != INVALID_SOCKET) &&
             p->callback (p, p->simulation_time_base + p->simulation_time, p->callback_context);
         pthread_mutex_lock (&p->io_lock);
         }
+    /* when running with registers published in shared memory, */
+    /* the register state is read directly from the published block */
+    if (p->shmem && (p->State == Run) &&
+        (0 == _panel_shmem_read (p)) &&
+        (p->callback)) {
+        pthread_mutex_unlock (&p->io_lock);
+        p->callback (p, p->simulation_time_base + p->simulation_time, p->callback_context);
+        pthread_mutex_lock (&p->io_lock);
+        }
     }
 pthread_mutex_unlock (&p->io_lock);
+/* stop any shared memory register publishing */
+if (p->shmem) {
+    _panel_debug (p, DBG_THR, "Stopping Publishing before exiting", NULL, 0);
+    _panel_sendf (p, &cmd_stat, NULL, "%s", register_publish_stop);
+    _panel_shmem_release (p);
+    }
 /* stop any established repeating activity in the simulator */
 if (p->parent == NULL) {        /* Top level panel? */
     _panel_debug (p, DBG_THR, "Stopping All Repeats before exiting", NULL, 0);
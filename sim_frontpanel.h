@@ -56,7 +56,7 @@ extern "C" {
 
 #if !defined(__VAX)         /* Unsupported platform */
 
-#define SIM_FRONTPANEL_VERSION   12
+#define SIM_FRONTPANEL_VERSION   13
 
 /**
 
@@ -225,6 +225,28 @@ sim_panel_set_display_callback_interval (PANEL *panel,
                                          void *context,
                                          int usecs_between_callbacks);
 
+/**
+
+    When the panel and the simulator run on the same host, the register
+    values delivered to a display callback can be read from a shared
+    memory block which the simulator rewrites at the callback interval
+    rather than being formatted as text by the simulator and parsed by
+    the panel API.
+
+    sim_panel_set_shared_memory
+
+        enable              non zero to deliver register values through
+                            shared memory, 0 to use the command channel
+
+   Note 1: Panels which have declared bit sample registers, and hosts
+           without shared memory support, keep using the command channel.
+   Note 2: On hosts other than Windows, sim_frontpanel.c must be compiled
+           with HAVE_SHM_OPEN defined for shared memory to be available.
+ */
+
+int
+sim_panel_set_shared_memory (PANEL *panel, int enable);
+
 /**
 
     When a front panel application wants to get averaged bit sample
@@ -59,6 +59,10 @@ extern "C" {
 #include <dlfcn.h>
 #endif
 
+#if !defined (_WIN32) && !defined (VMS)
+#include <sys/uio.h>                                    /* for writev */
+#endif
+
 #ifndef WSAAPI
 #define WSAAPI
 #endif
@@ -120,6 +124,11 @@ int sim_write_sock (SOCKET sock, char *msg, int nbytes)
 return 0;
 }
 
+int sim_write_sock_v (SOCKET sock, const char *msg1, int nbytes1, const char *msg2, int nbytes2)
+{
+return 0;
+}
+
 void sim_close_sock (SOCKET sock)
 {
 return;
@@ -1410,6 +1419,56 @@ if (sbytes == SOCKET_ERROR) {
 return sbytes;
 }
 
+/* Write two pieces of data with a single gathered send where the host
+   supports it, otherwise with consecutive sends.  The second piece is
+   only sent once all of the first has been accepted. */
+
+int sim_write_sock_v (SOCKET sock, const char *msg1, int nbytes1, const char *msg2, int nbytes2)
+{
+int err, sbytes;
+#if defined (_WIN32)
+WSABUF bufs[2];
+DWORD sent;
+
+bufs[0].buf = (char *)msg1;
+bufs[0].len = (u_long)nbytes1;
+bufs[1].buf = (char *)msg2;
+bufs[1].len = (u_long)nbytes2;
+if (WSASend (sock, bufs, 2, &sent, 0, NULL, NULL) == SOCKET_ERROR)
+    sbytes = SOCKET_ERROR;
+else
+    sbytes = (int)sent;
+#elif defined (VMS)
+int sbytes2;
+
+sbytes = sim_write_sock (sock, msg1, nbytes1);
+if (sbytes == nbytes1) {
+    sbytes2 = sim_write_sock (sock, msg2, nbytes2);
+    if (sbytes2 > 0)
+        sbytes += sbytes2;
+    }
+return sbytes;
+#else
+struct iovec iov[2];
+
+iov[0].iov_base = (void *)msg1;
+iov[0].iov_len = (size_t)nbytes1;
+iov[1].iov_base = (void *)msg2;
+iov[1].iov_len = (size_t)nbytes2;
+sbytes = (int)writev (sock, iov, 2);
+#endif
+if (sbytes == SOCKET_ERROR) {
+    err = WSAGetLastError ();
+    if (err == WSAEWOULDBLOCK)                          /* no data */
+        return 0;
+#if defined(EAGAIN)
+    if (err == EAGAIN)                                  /* no data */
+        return 0;
+#endif
+    }
+return sbytes;
+}
+
 void sim_close_sock (SOCKET sock)
 {
 shutdown(sock, SD_BOTH);
@@ -86,6 +86,7 @@
    sim_tape_show_capac  show tape capacity
    sim_tape_set_dens    set tape density
    sim_tape_show_dens   show tape density
+   sim_tape_show_stats  show I/O and position index statistics
    sim_tape_error_text  the textual description of a tape status
    sim_tape_set_async   enable asynchronous operation
    sim_tape_clr_async   disable asynchronous operation
@@ -139,11 +140,35 @@ static t_addr sim_tape_tpc_fnd (UNIT *uptr, t_addr *map);
 static void sim_tape_data_trace (UNIT *uptr, const uint8 *data, size_t len, const char* txt, int detail, uint32 reason);
 static t_stat tape_erase_fwd (UNIT *uptr, t_mtrlnt gap_size);
 static t_stat tape_erase_rev (UNIT *uptr, t_mtrlnt gap_size);
+static void sim_tape_flush (UNIT *uptr);
+
+typedef struct {
+    t_addr              from;               /* position the motion started at */
+    t_addr              to;                 /* position the motion ended at */
+    t_mtrlnt            bc;                 /* record length */
+    t_stat              st;                 /* MTSE_OK or MTSE_TMK */
+    } TAPE_INDEX_ENTRY;
+
+typedef struct {
+    TAPE_INDEX_ENTRY    *ent;               /* entries in ascending "from" order */
+    size_t              count;              /* entries in use */
+    size_t              size;               /* entries allocated */
+    t_addr              hiwater;            /* highest position any entry depends on */
+    } TAPE_INDEX;
 
 struct tape_context {
     DEVICE              *dptr;              /* Device for unit (access to debug flags) */
     uint32              dbit;               /* debugging bit for trace */
     uint32              auto_format;        /* Format determined dynamically */
+    uint8               *iobuf;             /* stdio read-ahead/write-behind buffer */
+    t_bool              io_write;           /* last file positioning was for a write */
+    t_uint64            seeks;              /* file seeks performed */
+    t_uint64            seeks_avoided;      /* file seeks not needed */
+    t_uint64            flushes;            /* write-behind buffer flushes */
+    TAPE_INDEX          fwd_index;          /* objects spaced over forward */
+    TAPE_INDEX          rev_index;          /* objects spaced over in reverse */
+    uint32              index_dens;         /* density the index entries were found at */
+    t_uint64            index_hits;         /* spacing done from the index */
 #if defined SIM_ASYNCH_IO
     t_bool              asynch_io;          /* Asynchronous Interrupt scheduling enabled */
     int                 asynch_io_latency;  /* instructions to delay pending interrupt */
@@ -168,6 +193,8 @@ struct tape_context {
     };
 #define tape_ctx up8                        /* Field in Unit structure which points to the tape_context */
 
+#define MT_IOBUF_SIZE   (256*1024)          /* size of per unit stdio buffer */
+
 #if defined SIM_ASYNCH_IO
 #define AIO_CALLSETUP                                                   \
 struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;       \
@@ -609,8 +636,7 @@ sim_tape_clr_async (uptr);
 if (sim_asynch_enabled)
     sim_tape_set_async (uptr, ctx->asynch_io_latency);
 #endif
-if (MT_GET_FMT (uptr) < MTUF_F_ANSI)
-    fflush (uptr->fileref);
+sim_tape_flush (uptr);
 }
 
 static const char *_sim_tape_format_name (UNIT *uptr)
@@ -926,6 +952,11 @@ uptr->tape_ctx = ctx = (struct tape_context *)calloc(1, sizeof(struct tape_conte
 ctx->dptr = dptr;                                       /* save DEVICE pointer */
 ctx->dbit = dbit;                                       /* save debug bit */
 ctx->auto_format = auto_format;                         /* save that we auto selected format */
+if (MT_GET_FMT (uptr) < MTUF_F_ANSI) {                  /* on-disk image? */
+    ctx->iobuf = (uint8 *)malloc (MT_IOBUF_SIZE);       /* give it a large buffer so */
+    if (ctx->iobuf != NULL)                             /* sequential records come from memory */
+        setvbuf (uptr->fileref, (char *)ctx->iobuf, _IOFBF, MT_IOBUF_SIZE);
+    }
 
 switch (MT_GET_FMT (uptr)) {                            /* case on format */
 
@@ -1025,6 +1056,11 @@ uptr->tape_eom = 0;
 uptr->pos = 0;
 MT_CLR_PNU (uptr);
 MT_CLR_INMRK (uptr);                                    /* Not within a TAR tapemark */
+if (ctx) {
+    free (ctx->iobuf);                                  /* file is closed, buffer no longer used */
+    free (ctx->fwd_index.ent);
+    free (ctx->rev_index.ent);
+    }
 free (uptr->tape_ctx);
 uptr->tape_ctx = NULL;
 uptr->io_flush = NULL;
@@ -1113,11 +1149,213 @@ if (sim_deb && ((uptr->dctrl | ctx->dptr->dctrl) & reason))
     sim_data_trace(ctx->dptr, uptr, (detail ? data : NULL), "", len, txt, reason);
 }
 
-static int sim_tape_seek (UNIT *uptr, t_addr pos)
+/* Record position index
+
+   Spacing over records in a container file reads the metadata of every
+   record passed over, which makes skipping to a file far down a tape slow.
+   Each successful space forward or reverse over a data record or tape mark
+   is remembered as a (from, to, status, length) entry kept in order of the
+   starting position, so a later space from the same position is a lookup
+   and the file is only positioned by the next read or write.  The attach
+   time validation pass spaces forward over every object on the tape, so
+   the forward index is normally complete once a tape has been attached.
+
+   An entry depends on the bytes between its two positions (AWS also looks
+   at the following header), so writing at a position discards all entries
+   that reach that position.  An erase gap may be a runaway at one density
+   and not another, so a density change discards the whole index.
+*/
+
+static t_bool sim_tape_index_usable (UNIT *uptr)
 {
-if (MT_GET_FMT (uptr) < MTUF_F_ANSI)
+switch (MT_GET_FMT (uptr)) {
+    case MTUF_F_STD:
+    case MTUF_F_E11:
+    case MTUF_F_TPC:
+    case MTUF_F_AWS:
+        return ((uptr->flags & UNIT_ATT) != 0) && (uptr->tape_ctx != NULL);
+    default:
+        return FALSE;
+    }
+}
+
+static size_t sim_tape_index_slot (TAPE_INDEX *ix, t_addr from)
+{
+size_t lo = 0, hi = ix->count;
+
+while (lo < hi) {                                       /* binary search for the first */
+    size_t mid = lo + (hi - lo) / 2;                    /*   entry at or beyond from */
+
+    if (ix->ent[mid].from < from)
+        lo = mid + 1;
+    else
+        hi = mid;
+    }
+return lo;
+}
+
+static void sim_tape_index_trim (TAPE_INDEX *ix, t_addr pos)
+{
+size_t i, j;
+
+if ((ix->count == 0) || (ix->hiwater < pos))            /* nothing at or past pos? */
+    return;
+ix->hiwater = 0;
+for (i = j = 0; i < ix->count; i++) {
+    t_addr last = (ix->ent[i].from > ix->ent[i].to) ? ix->ent[i].from : ix->ent[i].to;
+
+    if (last < pos) {                                   /* keep entries wholly before pos */
+        ix->ent[j++] = ix->ent[i];
+        if (last > ix->hiwater)
+            ix->hiwater = last;
+        }
+    }
+ix->count = j;
+}
+
+static void sim_tape_index_invalidate (UNIT *uptr, t_addr pos)
+{
+struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
+
+if (ctx == NULL)
+    return;
+sim_tape_index_trim (&ctx->fwd_index, pos);
+sim_tape_index_trim (&ctx->rev_index, pos);
+}
+
+static void sim_tape_index_check_dens (UNIT *uptr)
+{
+struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
+
+if (ctx->index_dens != MT_DENS (uptr->dynflags)) {      /* density changed? */
+    sim_tape_index_invalidate (uptr, 0);                /*   forget everything */
+    ctx->index_dens = MT_DENS (uptr->dynflags);
+    }
+}
+
+/* Remember the result of spacing from "from" to the current position */
+
+static void sim_tape_index_add (UNIT *uptr, TAPE_INDEX *ix, t_addr from, t_stat st, t_mtrlnt bc)
+{
+TAPE_INDEX_ENTRY *e;
+size_t i;
+
+if (((st != MTSE_OK) && (st != MTSE_TMK)) ||            /* only records and tape marks */
+    !sim_tape_index_usable (uptr))
+    return;
+sim_tape_index_check_dens (uptr);
+i = sim_tape_index_slot (ix, from);
+if ((i == ix->count) || (ix->ent[i].from != from)) {    /* new starting position? */
+    if (ix->count == ix->size) {
+        size_t size = (ix->size == 0) ? 256 : 2 * ix->size;
+        TAPE_INDEX_ENTRY *ent = (TAPE_INDEX_ENTRY *)realloc (ix->ent, size * sizeof (*ent));
+
+        if (ent == NULL)                                /* no memory? */
+            return;                                     /*   then just don't remember it */
+        ix->ent = ent;
+        ix->size = size;
+        }
+    memmove (&ix->ent[i + 1], &ix->ent[i], (ix->count - i) * sizeof (*ix->ent));
+    ++ix->count;
+    }
+e = &ix->ent[i];
+e->from = from;
+e->to = uptr->pos;
+e->st = st;
+e->bc = bc;
+if (from > ix->hiwater)
+    ix->hiwater = from;
+if (uptr->pos > ix->hiwater)
+    ix->hiwater = uptr->pos;
+}
+
+/* Space one object using the index; FALSE if the position isn't known */
+
+static t_bool sim_tape_index_space (UNIT *uptr, TAPE_INDEX *ix, t_mtrlnt *bc, t_stat *st)
+{
+struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
+size_t i;
+
+if (!sim_tape_index_usable (uptr))
+    return FALSE;
+if ((uptr->tape_eom > 0) &&                             /* at or past EOM? */
+    (uptr->pos >= uptr->tape_eom))                      /*   let the format code report it */
+    return FALSE;
+sim_tape_index_check_dens (uptr);
+i = sim_tape_index_slot (ix, uptr->pos);
+if ((i == ix->count) || (ix->ent[i].from != uptr->pos))
+    return FALSE;
+MT_CLR_PNU (uptr);
+uptr->pos = ix->ent[i].to;
+*bc = ix->ent[i].bc;
+*st = ix->ent[i].st;
+++ctx->index_hits;
+sim_debug_unit (MTSE_DBG_STR, uptr, "index: st: %d, lnt: %d, pos: %" T_ADDR_FMT "u\n", *st, *bc, uptr->pos);
+return TRUE;
+}
+
+/* Position the container file for a read (sim_tape_seek) or a write
+   (sim_tape_seek_wr).
+
+   A sim_fseek discards the stdio buffer, so when the file is already at
+   the requested position and the last access was in the same direction
+   the seek is skipped.  Sequential reads are then served from the
+   read-ahead buffer and sequential writes collect in the buffer until a
+   tape mark, rewind, reverse motion or detach.  A seek is always done
+   after end-of-file or an error so that the stream flags are reset.
+*/
+
+static int _sim_tape_seek (UNIT *uptr, t_addr pos, t_bool wr)
+{
+struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
+
+if (MT_GET_FMT (uptr) >= MTUF_F_ANSI)
+    return 0;
+if (ctx == NULL)
     return sim_fseek (uptr->fileref, pos, SEEK_SET);
-return 0;
+if (wr)                                                 /* data from here on is changing */
+    sim_tape_index_invalidate (uptr, pos);
+if ((ctx->io_write == wr) &&
+    !feof (uptr->fileref) && !ferror (uptr->fileref) &&
+    ((t_addr)sim_ftell (uptr->fileref) == pos)) {
+    ++ctx->seeks_avoided;
+    return 0;
+    }
+++ctx->seeks;
+ctx->io_write = wr;
+return sim_fseek (uptr->fileref, pos, SEEK_SET);
+}
+
+static int sim_tape_seek (UNIT *uptr, t_addr pos)
+{
+return _sim_tape_seek (uptr, pos, FALSE);
+}
+
+static int sim_tape_seek_wr (UNIT *uptr, t_addr pos)
+{
+return _sim_tape_seek (uptr, pos, TRUE);
+}
+
+/* Write any buffered data to the container file */
+
+static void sim_tape_flush (UNIT *uptr)
+{
+struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
+
+if ((MT_GET_FMT (uptr) >= MTUF_F_ANSI) || (uptr->fileref == NULL))
+    return;
+fflush (uptr->fileref);
+if (ctx)
+    ++ctx->flushes;
+}
+
+/* Set the container file size, buffered data must be written first */
+
+static int sim_tape_set_fsize (UNIT *uptr, t_addr size)
+{
+sim_tape_flush (uptr);
+sim_tape_index_invalidate (uptr, size);
+return sim_set_fsize (uptr->fileref, size);
 }
 
 static t_offset sim_tape_size (UNIT *uptr)
@@ -2074,7 +2312,7 @@ if (sim_tape_wrp (uptr))                                /* write prot? */
     return MTSE_WRP;
 if (sbc == 0)                                           /* nothing to do? */
     return MTSE_OK;
-if (sim_tape_seek (uptr, uptr->pos))                    /* set pos */
+if (sim_tape_seek_wr (uptr, uptr->pos))                 /* set pos */
     return MTSE_IOERR;
 switch (f) {                                            /* case on format */
 
@@ -2145,7 +2383,7 @@ if ((!sim_tape_bot (uptr)) &&
     MT_SET_PNU (uptr);                      /* pos not upd */
     return MTSE_INVRL;
     }
-if (sim_tape_seek (uptr, uptr->pos))        /* set pos */
+if (sim_tape_seek_wr (uptr, uptr->pos))     /* set pos */
     return MTSE_IOERR;
 replacing_record = (awshdr.nxtlen == (t_awslnt)bc) && (awshdr.rectyp == (bc ? AWS_REC : AWS_TMK));
 awshdr.nxtlen = (t_awslnt)bc;
@@ -2160,7 +2398,7 @@ if ((!replacing_record) || (bc == 0)) {
     awshdr.rectyp = AWS_TMK;
     (void)sim_fwrite (&awshdr, sizeof (t_awslnt), 3, uptr->fileref);
     if (!replacing_record)
-        sim_set_fsize (uptr->fileref, uptr->pos + sizeof (awshdr));
+        sim_tape_set_fsize (uptr, uptr->pos + sizeof (awshdr));
     }
 if (uptr->pos > uptr->tape_eom)
     uptr->tape_eom = uptr->pos;                     /* Update EOM if we're there */
@@ -2180,7 +2418,7 @@ if (ctx == NULL)                                        /* if not properly attac
     return sim_messagef (SCPE_IERR, "Bad Attach\n");    /*   that's a problem */
 if (sim_tape_wrp (uptr))                                /* write prot? */
     return MTSE_WRP;
-(void)sim_tape_seek (uptr, uptr->pos);                  /* set pos */
+(void)sim_tape_seek_wr (uptr, uptr->pos);               /* set pos */
 (void)sim_fwrite (&dat, sizeof (uint32), 1, uptr->fileref);
 if (ferror (uptr->fileref)) {                           /* error? */
     MT_SET_PNU (uptr);
@@ -2198,17 +2436,21 @@ return MTSE_OK;
 t_stat sim_tape_wrtmk (UNIT *uptr)
 {
 struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
+t_stat r;
 
 if (ctx == NULL)                                        /* if not properly attached? */
     return sim_messagef (SCPE_IERR, "Bad Attach\n");    /*   that's a problem */
 sim_debug_unit (ctx->dbit, uptr, "sim_tape_wrtmk(unit=%d)\n", (int)(uptr-ctx->dptr->units));
 if (MT_GET_FMT (uptr) == MTUF_F_P7B) {                  /* P7B? */
     uint8 buf = P7B_EOF;                                /* eof mark */
-    return sim_tape_wrrecf (uptr, &buf, 1);             /* write char */
+    r = sim_tape_wrrecf (uptr, &buf, 1);                /* write char */
     }
-if (MT_GET_FMT (uptr) == MTUF_F_AWS)                    /* AWS? */
-    return sim_tape_aws_wrdata (uptr, NULL, 0);
-return sim_tape_wrdata (uptr, MTR_TMK);
+else if (MT_GET_FMT (uptr) == MTUF_F_AWS)               /* AWS? */
+    r = sim_tape_aws_wrdata (uptr, NULL, 0);
+else
+    r = sim_tape_wrdata (uptr, MTR_TMK);
+sim_tape_flush (uptr);                                  /* file is complete, write it out */
+return r;
 }
 
 t_stat sim_tape_wrtmk_a (UNIT *uptr, TAPE_PCALLBACK callback)
@@ -2235,7 +2477,7 @@ if (sim_tape_wrp (uptr))                                /* write prot? */
 if (MT_GET_FMT (uptr) == MTUF_F_P7B)                    /* cant do P7B */
     return MTSE_FMT;
 if (MT_GET_FMT (uptr) == MTUF_F_AWS) {
-    sim_set_fsize (uptr->fileref, uptr->pos);
+    sim_tape_set_fsize (uptr, uptr->pos);
     result = MTSE_OK;
     }
 else {
@@ -2646,7 +2888,7 @@ if (gap_size == meta_size) {                            /* if the request is for
         return sim_tape_ioerr (uptr);                       /*   then report the error and quit */
 
     else if (metadatum == MTR_TMK)                          /* otherwise if a tape mark is present */
-        if (sim_tape_seek (uptr, uptr->pos))                /*   then reposition the tape; if it fails */
+        if (sim_tape_seek_wr (uptr, uptr->pos))             /*   then reposition the tape; if it fails */
             return sim_tape_ioerr (uptr);                   /*     then quit with I/O error status */
 
         else {                                              /*   otherwise */
@@ -2820,14 +3062,19 @@ t_stat sim_tape_sprecf (UNIT *uptr, t_mtrlnt *bc)
 {
 struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
 t_stat st;
+t_addr from;
 
 *bc = 0;
 if (ctx == NULL)                                        /* if not properly attached? */
     return sim_messagef (SCPE_IERR, "Bad Attach\n");    /*   that's a problem */
 sim_debug_unit (ctx->dbit, uptr, "sim_tape_sprecf(unit=%d)\n", (int)(uptr-ctx->dptr->units));
 
+if (sim_tape_index_space (uptr, &ctx->fwd_index, bc, &st))/* been here before? */
+    return st;
+from = uptr->pos;
 st = sim_tape_rdrlfwd (uptr, bc);                       /* get record length */
 *bc = MTR_L (*bc);
+sim_tape_index_add (uptr, &ctx->fwd_index, from, st, *bc);
 return st;
 }
 
@@ -2911,6 +3158,7 @@ t_stat sim_tape_sprecr (UNIT *uptr, t_mtrlnt *bc)
 {
 struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
 t_stat st;
+t_addr from;
 
 *bc = 0;
 if (ctx == NULL)                                        /* if not properly attached? */
@@ -2922,8 +3170,12 @@ if (MT_TST_PNU (uptr)) {
     *bc = 0;
     return MTSE_OK;
     }
+if (sim_tape_index_space (uptr, &ctx->rev_index, bc, &st))/* been here before? */
+    return st;
+from = uptr->pos;
 st = sim_tape_rdrlrev (uptr, bc);                       /* get record length */
 *bc = MTR_L (*bc);
+sim_tape_index_add (uptr, &ctx->rev_index, from, st, *bc);
 return st;
 }
 
@@ -3213,6 +3465,7 @@ if (uptr->flags & UNIT_ATT) {
     }
 uptr->pos = 0;
 if (uptr->flags & UNIT_ATT) {
+    sim_tape_flush (uptr);
     (void)sim_tape_seek (uptr, uptr->pos);
     }
 MT_CLR_PNU (uptr);
@@ -3815,6 +4068,25 @@ else {                                                  /* otherwise get the den
 return SCPE_OK;
 }
 
+/* show I/O buffering and position index statistics */
+
+t_stat sim_tape_show_stats (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
+{
+struct tape_context *ctx;
+
+if (uptr == NULL)                                       /* if the unit pointer is null */
+    return SCPE_IERR;                                   /*   then the caller has screwed up */
+ctx = (struct tape_context *)uptr->tape_ctx;
+if (((uptr->flags & UNIT_ATT) == 0) || (ctx == NULL))
+    fprintf (st, "not attached\n");
+else
+    fprintf (st, "seeks=%" T_UINT64_FMT "u, seeks avoided=%" T_UINT64_FMT "u, flushes=%" T_UINT64_FMT "u, "
+                 "index hits=%" T_UINT64_FMT "u, index entries=%u\n",
+                 ctx->seeks, ctx->seeks_avoided, ctx->flushes, ctx->index_hits,
+                 (uint32)(ctx->fwd_index.count + ctx->rev_index.count));
+return SCPE_OK;
+}
+
 /* list supported densities
 
    translates the mask of supported densities to a string list in the form:
@@ -1830,6 +1830,26 @@ void sim_throt_cancel (void)
 sim_cancel (&sim_throttle_unit);
 }
 
+/* Suspend idling and throttling for a BENCHMARK run, and restore them afterwards */
+
+void sim_timer_benchmark (t_bool start)
+{
+static t_bool saved_idle_enab;
+static uint32 saved_throt_type;
+
+if (start) {
+    saved_idle_enab = sim_idle_enab;
+    saved_throt_type = sim_throt_type;
+    sim_idle_enab = FALSE;
+    sim_throt_type = SIM_THROT_NONE;
+    sim_throt_cancel ();
+    }
+else {
+    sim_idle_enab = saved_idle_enab;
+    sim_throt_type = saved_throt_type;
+    }
+}
+
 /* Throttle service
 
    Throttle service has three distinct states used while dynamically
@@ -129,6 +129,7 @@ t_stat sim_clr_idle (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat sim_show_idle (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
 void sim_throt_sched (void);
 void sim_throt_cancel (void);
+void sim_timer_benchmark (t_bool start);
 uint32 sim_os_msec (void);
 void sim_os_sleep (unsigned int sec);
 uint32 sim_os_ms_sleep (unsigned int msec);
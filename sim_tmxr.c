@@ -71,6 +71,7 @@
    tmxr_get_packet_ln_ex -              get packet from line with separator byte
    tmxr_poll_rx -                       poll receive
    tmxr_putc_ln -                       put character for line
+   tmxr_put_block_ln -                  put block of characters for line
    tmxr_put_packet_ln -                 put packet on line
    tmxr_put_packet_ln_ex -              put packet on line with separator byte
    tmxr_poll_tx -                       poll transmit
@@ -509,6 +510,7 @@ lp->rxbpr = lp->rxbpi = lp->rxcnt = lp->rxpcnt = 0;     /* init receive indexes
 if (!lp->txbfd || lp->notelnet)                         /* if not buffered telnet */
     lp->txbpr = lp->txbpi = lp->txcnt = lp->txpcnt = 0; /*   init transmit indexes */
 lp->txdrp = lp->txstall = 0;
+lp->txwrites = lp->txgwrites = 0;
 tmxr_set_get_modem_bits (lp, 0, 0, NULL);
 if (lp->mp && (!lp->mp->buffered) && (!lp->txbfd)) {
     lp->txbfd = 0;
@@ -577,6 +579,7 @@ if (!mp->buffered) {
     lp->txbpr = (int32)(lp->txbsz - strlen (msgbuf));
     lp->rxcnt = lp->txcnt = lp->txdrp = lp->txstall = 0;/* init counters */
     lp->rxpcnt = lp->txpcnt = 0;
+    lp->txwrites = lp->txgwrites = 0;
     }
 else
     if (lp->txcnt > lp->txbsz)
@@ -783,6 +786,7 @@ else {
     }
 if (written > 0) {
     lp->txdone = FALSE;
+    ++lp->txwrites;
     if ((lp->txbps) && (sim_is_running))
         lp->txnexttime = floor (sim_gtime () + ((written * lp->txdeltausecs * sim_timer_inst_per_sec ()) / USECS_PER_SECOND));
     }
@@ -790,6 +794,38 @@ return written;
 }
 
 
+/* Write wrapped data to a line.
+
+   Up to "length" characters, which wrap around the end of the transmit buffer
+   associated with "lp", are written.  A plain network connection takes both
+   pieces with a single gathered write.  Other lines (speed limited, loopback,
+   serial, framer or datagram) only write the piece up to the end of the
+   buffer.  The actual number of characters written is returned.  If an error
+   occurred while writing, -1 is returned.
+*/
+
+static int32 tmxr_write_wrapped (TMLN *lp, int32 length)
+{
+int32 written;
+int32 first = lp->txbsz - lp->txbpr;
+
+if ((length <= first) || (lp->txbps) || (lp->loopback) || (lp->serport) ||
+    (lp->framer) || (lp->datagram) || (!lp->sock))
+    return tmxr_write (lp, first);
+written = sim_write_sock_v (lp->sock, &(lp->txb[lp->txbpr]), first, lp->txb, length - first);
+if (written == SOCKET_ERROR) {                          /* did an error occur? */
+    lp->txdone = TRUE;
+    return -1;                                          /* return error indication */
+    }
+if (written > 0) {
+    lp->txdone = FALSE;
+    ++lp->txwrites;
+    ++lp->txgwrites;
+    }
+return written;
+}
+
+
 /* Remove a character from the read buffer.
 
    The character at position "p" in the read buffer associated with line "lp" is
@@ -935,6 +971,8 @@ if (mp->logfiletmpl[0])                                 /* logfile info */
     sprintf (growstring(&tptr, 7 + strlen (mp->logfiletmpl)), ",Log=%s", mp->logfiletmpl);
 if (mp->buffered)
     sprintf (growstring(&tptr, 10 + 10), ",Buffered=%d", mp->buffered);
+if (mp->outbuffer)
+    sprintf (growstring(&tptr, 11 + 10), ",OutBuffer=%d", mp->outbuffer);
 while ((*tptr == ',') || (*tptr == ' '))
     memmove (tptr, tptr+1, strlen(tptr+1)+1);
 for (i=0; i<mp->lines; ++i) {
@@ -995,6 +1033,8 @@ if (lp->destination || lp->port || lp->txlogname || (lp->conn == TMXR_LINE_DISAB
         sprintf (growstring(&tptr, 32), ",Buffered=%d", lp->txbsz);
     if (!lp->txbfd && (lp->mp->buffered > 0))
         sprintf (growstring(&tptr, 32), ",UnBuffered");
+    if (!lp->txbfd && (lp->txbszmax != lp->mp->outbuffer))
+        sprintf (growstring(&tptr, 32), ",OutBuffer=%d", lp->txbszmax);
     if (lp->mp->datagram != lp->datagram)
         sprintf (growstring(&tptr, 8), ",%s", lp->datagram ? "UDP" : "TCP");
     if (lp->mp->packet != lp->packet)
@@ -2447,6 +2487,55 @@ return (lp->rxbpi - lp->rxbpr);
 }
 
 
+/* Grow a line's transmit buffer
+
+   Inputs:
+        *lp     =       pointer to line descriptor
+        needed  =       buffer size wanted
+   Outputs:
+        TRUE if the buffer was grown
+
+   Implementation note:
+
+    1. Only unbuffered stream lines with a growth limit (ATTACH OUTBUFFER=n)
+       grow.  The buffer size is doubled until it covers "needed" or reaches
+       the limit.  Queued data is moved to the start of the new buffer.
+*/
+
+static t_bool tmxr_grow_txb (TMLN *lp, int32 needed)
+{
+int32 size = lp->txbsz;
+int32 queued = tmxr_tqln (lp);
+int32 first;
+char *txb;
+
+if ((lp->txbfd) || (lp->serport) || (lp->loopback) || (lp->framer) ||
+    (lp->datagram) || (lp->txbszmax <= lp->txbsz))
+    return FALSE;
+while ((size < needed) && (size < lp->txbszmax))
+    size = size * 2;
+if (size > lp->txbszmax)
+    size = lp->txbszmax;
+if (size <= lp->txbsz)
+    return FALSE;
+txb = (char *)malloc (size);
+if (txb == NULL)
+    return FALSE;
+if (lp->txbpr <= lp->txbpi)                             /* no wrap? */
+    memcpy (txb, &(lp->txb[lp->txbpr]), queued);
+else {
+    first = lp->txbsz - lp->txbpr;
+    memcpy (txb, &(lp->txb[lp->txbpr]), first);
+    memcpy (txb + first, lp->txb, lp->txbpi);
+    }
+free (lp->txb);
+lp->txb = txb;
+lp->txbsz = size;
+lp->txbpr = 0;
+lp->txbpi = queued;
+return TRUE;
+}
+
 /* Store character in line buffer
 
    Inputs:
@@ -2475,6 +2564,8 @@ tmxr_debug_trace_line (lp, "tmxr_putc_ln()");
     if (lp->txbpi == lp->txbpr)                           \
         lp->txbpr = (1+lp->txbpr)%lp->txbsz, ++lp->txdrp; \
     }
+if (lp->conn && (TXBUF_AVAIL(lp) <= TMXR_GUARD + 1))    /* nearly full? */
+    tmxr_grow_txb (lp, lp->txbsz + 1);                  /* grow if allowed */
 if ((lp->xmte == 0) && (TXBUF_AVAIL(lp) > 1) &&
     ((lp->txbps == 0) || (lp->txnexttime <= sim_gtime ())))
     lp->xmte = 1;                                       /* enable line transmit */
@@ -2509,6 +2600,93 @@ if ((lp->conn && (TXBUF_AVAIL(lp) > 1)) ||              /* connected and room fo
 return SCPE_STALL;                                      /* char not sent */
 }
 
+/* Store block of characters in line buffer
+
+   Inputs:
+        *lp     =       pointer to line descriptor
+        *buf    =       pointer to data
+        size    =       size of data
+        *count  =       pointer to count of characters stored (may be NULL)
+   Outputs:
+        status  =       ok, connection lost, or stall
+
+   Implementation notes:
+
+    1. The result is the same as storing each character with tmxr_putc_ln,
+       stopping at the first one which isn't stored.  While the simulator
+       is running, data on a connected line which needs no Telnet escapes
+       and no expect rule processing is copied into the buffer in at most
+       two pieces (and logged with one write).
+    2. If the line is not connected, SCPE_LOST is returned and all of the
+       data is counted as dropped.
+    3. If the buffer fills, it grows up to the line's OUTBUFFER limit.
+       Otherwise SCPE_STALL is returned and "count" tells how much of the
+       data was stored.  The caller must retry the remainder later.
+*/
+
+t_stat tmxr_put_block_ln (TMLN *lp, const uint8 *buf, size_t size, size_t *count)
+{
+size_t done = 0;
+size_t n, first;
+t_stat r = SCPE_OK;
+
+if (count)
+    *count = 0;
+if (size == 0)
+    return SCPE_OK;
+if ((!lp->conn) || (!sim_is_running) || (lp->expect.size != 0) ||
+    ((!lp->notelnet) && (memchr (buf, TN_IAC, size) != NULL))) {
+    while (done < size) {                               /* do it the slow way */
+        r = tmxr_putc_ln (lp, buf[done]);
+        if (r != SCPE_OK) {
+            if (r == SCPE_LOST)                         /* rest is lost too */
+                lp->txdrp += (int32)(size - done - 1);
+            break;
+            }
+        ++done;
+        }
+    if (count)
+        *count = done;
+    return r;
+    }
+tmxr_debug_trace_line (lp, "tmxr_put_block_ln()");
+if ((size_t)TXBUF_AVAIL(lp) <= size)                    /* won't fit? */
+    tmxr_grow_txb (lp, tmxr_tqln (lp) + (int32)size + TMXR_GUARD + 1);
+if ((lp->xmte == 0) && (TXBUF_AVAIL(lp) > 1) &&
+    ((lp->txbps == 0) || (lp->txnexttime <= sim_gtime ())))
+    lp->xmte = 1;                                       /* enable line transmit */
+n = (size_t)(TXBUF_AVAIL(lp) - 1);                      /* room in buffer */
+if (n > size)
+    n = size;
+if (n > 0) {
+    first = (size_t)(lp->txbsz - lp->txbpi);            /* room before wrap */
+    if (first > n)
+        first = n;
+    memcpy (&(lp->txb[lp->txbpi]), buf, first);
+    memcpy (lp->txb, buf + first, n - first);
+    lp->txbpi = (int32)((lp->txbpi + n) % lp->txbsz);
+    if (((!lp->txbfd) &&
+         (TXBUF_AVAIL (lp) <= TMXR_GUARD)) ||           /* near full? */
+        (lp->txbps))                                    /* or we're rate limiting output */
+        lp->xmte = 0;                                   /* disable line transmit until space available or character time has passed */
+    if (lp->txlog) {                                    /* log if available */
+        extern TMLN *sim_oline;                         /* Make sure to avoid recursion */
+        TMLN *save_oline = sim_oline;                   /* when logging to a socket */
+
+        sim_oline = NULL;                               /* save output socket */
+        fwrite (buf, 1, n, lp->txlog);                  /* log to actual file */
+        sim_oline = save_oline;                         /* restore output socket */
+        }
+    }
+if (count)
+    *count = n;
+if (n < size) {
+    ++lp->txstall; lp->xmte = 0;                        /* no room, dsbl line */
+    return SCPE_STALL;                                  /* not all sent */
+    }
+return SCPE_OK;
+}
+
 /* Store packet in line buffer
 
    Inputs:
@@ -2620,12 +2798,17 @@ if (nbytes) {                                           /* >0? write */
     if (lp->txbpr < lp->txbpi)                          /* no wrap? */
         sbytes = tmxr_write (lp, nbytes);               /* write all data */
     else
-        sbytes = tmxr_write (lp, lp->txbsz - lp->txbpr);/* write to end buf */
+        sbytes = tmxr_write_wrapped (lp, nbytes);       /* write to end buf (and beyond) */
     if (sbytes >= 0) {                                  /* ok? */
-        tmxr_debug (TMXR_DBG_XMT, lp, "Sent", &(lp->txb[lp->txbpr]), sbytes);
+        if (lp->txbpr + sbytes > lp->txbsz) {           /* gathered across the wrap? */
+            tmxr_debug (TMXR_DBG_XMT, lp, "Sent", &(lp->txb[lp->txbpr]), lp->txbsz - lp->txbpr);
+            tmxr_debug (TMXR_DBG_XMT, lp, "Sent", lp->txb, lp->txbpr + sbytes - lp->txbsz);
+            }
+        else
+            tmxr_debug (TMXR_DBG_XMT, lp, "Sent", &(lp->txb[lp->txbpr]), sbytes);
         lp->txbpr = (lp->txbpr + sbytes);               /* update remove ptr */
         if (lp->txbpr >= lp->txbsz)                     /* wrap? */
-            lp->txbpr = 0;
+            lp->txbpr -= lp->txbsz;
         lp->txcnt = lp->txcnt + sbytes;                 /* update counts */
         nbytes = nbytes - sbytes;
         if ((nbytes == 0) && (lp->datagram))            /* if Empty buffer on datagram line */
@@ -2903,7 +3086,7 @@ t_stat tmxr_open_master (TMXR *mp, CONST char *cptr)
 {
 int32 i, line, nextline = -1;
 char tbuf[CBUFSIZE], listen[CBUFSIZE], destination[CBUFSIZE],
-     logfiletmpl[CBUFSIZE], buffered[CBUFSIZE], hostport[CBUFSIZE],
+     logfiletmpl[CBUFSIZE], buffered[CBUFSIZE], outbuffer[CBUFSIZE], hostport[CBUFSIZE],
      port[CBUFSIZE], option[CBUFSIZE], speed[CBUFSIZE], dev_name[CBUFSIZE],
      acl[CBUFSIZE];
 char framer[CBUFSIZE],fr_eth[CBUFSIZE];
@@ -2942,6 +3125,7 @@ while (*tptr) {
     memset(listen,      '\0', sizeof(listen));
     memset(destination, '\0', sizeof(destination));
     memset(buffered,    '\0', sizeof(buffered));
+    memset(outbuffer,   '\0', sizeof(outbuffer));
     memset(port,        '\0', sizeof(port));
     memset(acl,         '\0', sizeof(acl));
     memset(option,      '\0', sizeof(option));
@@ -2952,6 +3136,8 @@ while (*tptr) {
     packet = mp->packet;
     if (mp->buffered)
         sprintf(buffered, "%d", mp->buffered);
+    if (mp->outbuffer)
+        sprintf(outbuffer, "%d", mp->outbuffer);
     if (line != -1) {
         notelnet = listennotelnet = mp->notelnet;
         nomessage = listennomessage = mp->nomessage;
@@ -3005,6 +3191,15 @@ while (*tptr) {
                     }
                 continue;
                 }
+            if (0 == MATCH_CMD (gbuf, "OUTBUFFER")) {
+                if ((NULL == cptr) || ('\0' == *cptr))
+                    return sim_messagef (SCPE_2FARG, "Missing OutBuffer Specifier\n");
+                i = (int32) get_uint (cptr, 10, TMXR_MAXOUTBUF, &r);
+                if (r || ((i != 0) && (i < TMXR_MAXBUF)))
+                    return sim_messagef (SCPE_ARG, "Invalid OutBuffer Specifier: %s\n", cptr);
+                sprintf(outbuffer, "%d", i);
+                continue;
+                }
             if (0 == MATCH_CMD (gbuf, "NOLOG")) {
                 if ((NULL != cptr) && ('\0' != *cptr))
                     return sim_messagef (SCPE_2MARG, "Unexpected NoLog Specifier: %s\n", cptr);
@@ -3282,8 +3477,10 @@ while (*tptr) {
                 }
             }
         mp->buffered = atoi(buffered);
+        mp->outbuffer = atoi(outbuffer);
         for (i = 0; i < mp->lines; i++) { /* initialize line buffers */
             lp = mp->ldsc + i;
+            lp->txbszmax = mp->outbuffer;
             if (mp->buffered) {
                 lp->txbsz = mp->buffered;
                 lp->txbfd = 1;
@@ -3517,6 +3714,7 @@ while (*tptr) {
             lp->rxbsz = lp->txbsz = atoi(buffered);
             lp->txbfd = 1;
             }
+        lp->txbszmax = atoi(outbuffer);
         lp->txbpi = lp->txbpr = 0;
         lp->txb = (char *)realloc (lp->txb, lp->txbsz);
         lp->rxb = (char *)realloc(lp->rxb, lp->rxbsz);
@@ -4526,6 +4724,8 @@ if (mp->modem_control)
     fprintf(st, ", ModemControl=enabled");
 if (mp->buffered)
     fprintf(st, ", Buffered=%d", mp->buffered);
+if (mp->outbuffer)
+    fprintf(st, ", OutBuffer=%d", mp->outbuffer);
 for (j = 1; j < mp->lines; j++)
     if (o_uptr != mp->ldsc[j].o_uptr)
         break;
@@ -4965,6 +5165,10 @@ if (single_line) {          /* Single Line Multiplexer */
     fprintf (st, "Line buffering can be disabled for the %s device with:\n\n", dptr->name);
     fprintf (st, "   sim> ATTACH %s NoBuffer\n\n", dptr->name);
     fprintf (st, "The default buffer size is 32k bytes, the max buffer size is 1024k bytes\n\n");
+    fprintf (st, "The output buffer of an unbuffered line is normally 256 bytes.  It can\n");
+    fprintf (st, "be allowed to grow on demand, up to a limit, with:\n\n");
+    fprintf (st, "   sim> ATTACH %s OutBuffer=limit\n\n", dptr->name);
+    fprintf (st, "The max limit is 1024k bytes, OutBuffer=0 keeps the buffer size fixed\n\n");
     fprintf (st, "The outbound traffic the %s device can be logged to a file with:\n", dptr->name);
     fprintf (st, "   sim> ATTACH %s Log=LogFileName\n\n", dptr->name);
     fprintf (st, "File logging can be disabled for the %s device with:\n\n", dptr->name);
@@ -5000,6 +5204,10 @@ else {
         fprintf (st, "Line buffering for all lines on the %s device can be disabled with:\n\n", dptr->name);
     fprintf (st, "   sim> ATTACH %s NoBuffer\n\n", dptr->name);
     fprintf (st, "The default buffer size is 32k bytes, the max buffer size is 1024k bytes\n\n");
+    fprintf (st, "The output buffer of an unbuffered line is normally 256 bytes.  It can\n");
+    fprintf (st, "be allowed to grow on demand, up to a limit, with:\n\n");
+    fprintf (st, "   sim> ATTACH %s OutBuffer=limit\n\n", dptr->name);
+    fprintf (st, "The max limit is 1024k bytes, OutBuffer=0 keeps the buffer size fixed\n\n");
     fprintf (st, "The outbound traffic for the lines of the %s device can be logged to files\n", dptr->name);
     fprintf (st, "with:\n\n");
     fprintf (st, "   sim> ATTACH %s Log=LogFileName\n\n", dptr->name);
@@ -5211,16 +5419,28 @@ if ((sock) && (sock != INVALID_SOCKET))
 }
 
 
+/* Write a block of a message to a line, waiting for room as needed */
+
+static void tmxr_linemsg_block (TMLN *lp, const char *msg, size_t len)
+{
+size_t sent;
+
+while (len > 0) {
+    if (SCPE_STALL != tmxr_put_block_ln (lp, (const uint8 *)msg, len, &sent))
+        break;
+    msg += sent;
+    len -= sent;
+    if (lp->txbsz == tmxr_send_buffered_data (lp))
+        sim_os_ms_sleep (10);
+    }
+}
+
+
 /* Write a message to a line */
 
 void tmxr_linemsg (TMLN *lp, const char *msg)
 {
-while (*msg) {
-    while (SCPE_STALL == tmxr_putc_ln (lp, (int32)(*msg)))
-        if (lp->txbsz == tmxr_send_buffered_data (lp))
-            sim_os_ms_sleep (10);
-    ++msg;
-    }
+tmxr_linemsg_block (lp, msg, strlen (msg));
 }
 
 
@@ -5240,7 +5460,7 @@ void tmxr_linemsgvf (TMLN *lp, const char *fmt, va_list arglist)
 char stackbuf[STACKBUFSIZE];
 int32 bufsize = sizeof(stackbuf);
 char *buf = stackbuf;
-int32 i, len;
+int32 i, j, len;
 
 buf[bufsize-1] = '\0';
 while (1) {                                         /* format passed string, args */
@@ -5269,16 +5489,14 @@ while (1) {                                         /* format passed string, arg
 
 /* Output the formatted data expanding newlines where they exist */
 
-for (i = 0; i < len; ++i) {
+for (i = j = 0; i < len; ++i) {
     if (('\n' == buf[i]) && ((i == 0) || ('\r' != buf[i-1]))) {
-        while (SCPE_STALL == tmxr_putc_ln (lp, '\r'))
-            if (lp->txbsz == tmxr_send_buffered_data (lp))
-                sim_os_ms_sleep (10);
+        tmxr_linemsg_block (lp, buf + j, i - j);
+        tmxr_linemsg_block (lp, "\r", 1);
+        j = i;
         }
-    while (SCPE_STALL == tmxr_putc_ln (lp, buf[i]))
-        if (lp->txbsz == tmxr_send_buffered_data (lp))
-            sim_os_ms_sleep (10);
     }
+tmxr_linemsg_block (lp, buf + j, len - j);
 if (buf != stackbuf)
     free (buf);
 }
@@ -5395,6 +5613,18 @@ else {
     }
 if (lp->txbfd)
     fprintf (st, "  output buffer size = %d\n", lp->txbsz);
+else if (lp->txbszmax)
+    fprintf (st, "  output buffer size = %d (limit %d)\n", lp->txbsz, lp->txbszmax);
+if (lp->txwrites) {
+    uint32 ms = sim_os_msec () - lp->cnms;
+
+    fprintf (st, "  output writes = %d", lp->txwrites);
+    if (lp->txgwrites)
+        fprintf (st, " (%d gathered)", lp->txgwrites);
+    fprintf (st, ", %.1f bytes/write\n", (double)lp->txcnt / lp->txwrites);
+    if (lp->cnms && (ms > 0))
+        fprintf (st, "  output rate = %.0f bytes/sec\n", (1000.0 * lp->txcnt) / ms);
+    }
 if (lp->txcnt || lp->txbpi)
     fprintf (st, "  bytes in buffer = %d\n",
                ((lp->txcnt > 0) && (lp->txcnt > lp->txbsz)) ? lp->txbsz : lp->txbpi);
@@ -61,6 +61,7 @@ typedef struct SERPORT *SERHANDLE;
 #define TMXR_V_VALID    15
 #define TMXR_VALID      (1 << TMXR_V_VALID)
 #define TMXR_MAXBUF     256                             /* buffer size */
+#define TMXR_MAXOUTBUF  (1024*1024)                     /* max growable xmt buffer size */
 
 #define TMXR_DTR_DROP_TIME 500                          /* milliseconds to drop DTR for 'pseudo' modem control */
 #define TMXR_MODEM_RING_TIME 3                          /* seconds to wait for DTR for incoming connections */
@@ -166,6 +167,9 @@ struct tmln {
     int32               txstall;                        /* xmt stall count */
     int32               txbsz;                          /* xmt buffer size */
     int32               txbfd;                          /* xmt buffered flag */
+    int32               txbszmax;                       /* xmt buffer growth limit (0 - fixed size) */
+    int32               txwrites;                       /* xmt write count */
+    int32               txgwrites;                      /* xmt gathered write count */
     t_bool              modem_control;                  /* line supports modem control behaviors */
     t_bool              port_speed_control;             /* line programmatically sets port speed */
     int32               modembits;                      /* modem bits which are currently set */
@@ -228,6 +232,7 @@ struct tmxr {
     char                logfiletmpl[FILENAME_MAX];      /* template logfile name */
     int32               txcount;                        /* count of transmit bytes */
     int32               buffered;                       /* Buffered Line Behavior and Buffer Size Flag */
+    int32               outbuffer;                      /* default xmt buffer growth limit for lines */
     int32               sessions;                       /* count of tcp connections received */
     uint32              poll_interval;                  /* frequency of connection polls (seconds) */
     uint32              last_poll_time;                 /* time of last connection poll */
@@ -251,6 +256,7 @@ t_stat tmxr_get_packet_ln (TMLN *lp, const uint8 **pbuf, size_t *psize);
 t_stat tmxr_get_packet_ln_ex (TMLN *lp, const uint8 **pbuf, size_t *psize, uint8 frame_byte);
 void tmxr_poll_rx (TMXR *mp);
 t_stat tmxr_putc_ln (TMLN *lp, int32 chr);
+t_stat tmxr_put_block_ln (TMLN *lp, const uint8 *buf, size_t size, size_t *count);
 t_stat tmxr_put_packet_ln (TMLN *lp, const uint8 *buf, size_t size);
 t_stat tmxr_put_packet_ln_ex (TMLN *lp, const uint8 *buf, size_t size, uint8 frame_byte);
 void tmxr_poll_tx (TMXR *mp);